@@ -0,0 +1,88 @@
+// KatanaReaderNX – host micro-benchmark harness
+// Each benchmark file registers one or more groups with BENCH_GROUP; a group
+// calls measure() once per case. measure() repeats the operation until it has
+// run for at least the minimum time and records ns/op, MB/s and the number of
+// heap allocations made per operation.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Heap allocations seen by the malloc hooks in alloc.cpp
+uint64_t benchAllocCount();
+uint64_t benchAllocBytes();
+
+// Sample pages (bench_decode.cpp): sorted file names in `dir`, and a whole
+// file read into memory.
+std::vector<std::string> benchPageFiles(const std::string &dir);
+bool benchReadFile(const std::string &path, std::vector<uint8_t> &out);
+
+class BenchSuite {
+public:
+  struct Result {
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    double mbPerSec;      // 0 when the case has no byte count
+    double allocsPerOp;
+    double allocBytesPerOp;
+  };
+
+  // Time `op`. `bytesPerOp` is the amount of data one call processes and is
+  // only used to report throughput.
+  template <class Op>
+  void measure(const std::string &name, size_t bytesPerOp, Op &&op) {
+    if (!selected(name))
+      return;
+    op(); // warm up
+    uint64_t iters = 1;
+    for (;;) {
+      uint64_t allocs = benchAllocCount(), bytes = benchAllocBytes();
+      uint64_t t0 = nowNs();
+      for (uint64_t i = 0; i < iters; i++)
+        op();
+      uint64_t elapsed = nowNs() - t0;
+      if (elapsed >= minTimeNs || iters >= (1ull << 30)) {
+        record(name, bytesPerOp, iters, elapsed, benchAllocCount() - allocs,
+               benchAllocBytes() - bytes);
+        return;
+      }
+      // Aim a little past the minimum time on the next attempt
+      iters = elapsed ? iters * minTimeNs * 12 / 10 / elapsed + 1 : iters * 10;
+    }
+  }
+
+  // Command line: --filter SUBSTR, --min-time MS, --json FILE, --pages DIR
+  bool parseArgs(int argc, char *argv[]);
+  std::string pagesDir = "bench/pages"; // sample images for decode benches
+
+  const std::vector<Result> &results() const { return all; }
+  bool writeJson(const std::string &path) const;
+  std::string jsonPath;
+
+  static uint64_t nowNs();
+  bool selected(const std::string &name) const;
+
+  // Cases that check something rather than time it report failures here;
+  // the runner then exits with status 1.
+  void fail(const std::string &why);
+  bool failed = false;
+
+private:
+  void record(const std::string &name, size_t bytesPerOp, uint64_t iters,
+              uint64_t elapsedNs, uint64_t allocs, uint64_t allocBytes);
+
+  std::string filter;
+  uint64_t minTimeNs = 200000000ull;
+  std::vector<Result> all;
+};
+
+typedef void (*BenchGroupFn)(BenchSuite &suite);
+
+struct BenchRegistrar {
+  BenchRegistrar(const char *group, BenchGroupFn fn);
+};
+
+#define BENCH_GROUP(name, fn) static BenchRegistrar fn##Registrar(name, fn)
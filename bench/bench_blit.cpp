@@ -0,0 +1,100 @@
+// KatanaReaderNX – benchmarks: framebuffer blits
+// blitPortrait at several scrolls and scales, the continuous strip blitter
+// on whole and tiled pages, a scroll-blit step, and full frames across
+// 1..MAX_RENDER_THREADS threads.
+
+#include "bench.h"
+#include "render.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const size_t FRAME_BYTES = (size_t)SCREEN_W * SCREEN_H * 4;
+
+static void fillNoise(DecodedImage &img, int w, int h) {
+  img.w = w;
+  img.h = h;
+  img.pixels = (uint8_t *)malloc((size_t)w * h * 4);
+  uint32_t x = 12345;
+  for (size_t i = 0; i < (size_t)w * h * 4; i++) {
+    x = x * 1664525u + 1013904223u;
+    img.pixels[i] = (uint8_t)(x >> 24);
+  }
+}
+
+static void blitGroup(BenchSuite &suite) {
+  std::vector<uint32_t> fb(SCREEN_W * SCREEN_H);
+  char name[96];
+
+  // Page mode: the image height is fitted to 1280px, so these sizes cover an
+  // upscale, roughly 1:1 and a 2x downscale.
+  static const int PAGES[][2] = {{400, 600}, {800, 1200}, {1600, 2400}};
+  for (const auto &size : PAGES) {
+    DecodedImage img;
+    fillNoise(img, size[0], size[1]);
+    for (int scroll : {0, -240, -480}) {
+      snprintf(name, sizeof(name), "blit/portrait/%dx%d/scroll%d", size[0],
+               size[1], scroll);
+      suite.measure(name, FRAME_BYTES,
+                    [&] { blitPortrait(fb.data(), img, scroll); });
+    }
+  }
+
+  // Continuous mode strips
+  static const int STRIPS[][2] = {{720, 5000}, {1440, 10000}};
+  for (const auto &size : STRIPS) {
+    DecodedImage img;
+    fillNoise(img, size[0], size[1]);
+    snprintf(name, sizeof(name), "blit/strip/%dx%d", size[0], size[1]);
+    suite.measure(name, FRAME_BYTES,
+                  [&] { blitStrip(fb.data(), img, -2000); });
+  }
+
+  // A webtoon page held as tiles, with every tile decoded
+  {
+    DecodedImage img;
+    fillNoise(img, 720, 15000);
+    DecodedImage *tiled = tilePage(img);
+    size_t tileBytes = (size_t)TILE_ROWS * img.w * 4;
+    for (size_t t = 0; t < tiled->tiles.size(); t++) {
+      tiled->tiles[t] = (uint8_t *)malloc(tileBytes);
+      size_t rows = std::min<size_t>(TILE_ROWS, img.h - t * TILE_ROWS);
+      memcpy(tiled->tiles[t], img.pixels + t * tileBytes, rows * img.w * 4);
+    }
+    suite.measure("blit/strip-tiled/720x15000", FRAME_BYTES,
+                  [&] { blitStrip(fb.data(), *tiled, -2000); });
+    delete tiled;
+  }
+
+  // One 20px scroll step in page mode: shift plus exposed band
+  {
+    DecodedImage img;
+    fillNoise(img, 800, 1200);
+    FrameState fs;
+    fs.count = 1;
+    fs.vis[0] = {0, &img, -200};
+    suite.measure("blit/scroll-step/800x1200", FRAME_BYTES, [&] {
+      shiftFrame(fb.data(), fb.data(), 0, -20);
+      drawFrame(fb.data(), fs, exposedBand(0, -20));
+    });
+  }
+
+  // Full frames split across the render worker team
+  for (const auto &size : PAGES) {
+    DecodedImage img;
+    fillNoise(img, size[0], size[1]);
+    FrameState fs;
+    fs.count = 1;
+    fs.vis[0] = {0, &img, -240};
+    for (int threads = 1; threads <= MAX_RENDER_THREADS; threads++) {
+      renderSetThreads(threads);
+      snprintf(name, sizeof(name), "blit/frame/%dx%d/threads%d", size[0],
+               size[1], threads);
+      suite.measure(name, FRAME_BYTES,
+                    [&] { drawFrame(fb.data(), fs, FULL_SCREEN); });
+    }
+  }
+  renderSetThreads(1);
+}
+BENCH_GROUP("blit", blitGroup);
@@ -0,0 +1,66 @@
+// KatanaReaderNX – benchmarks: page decoding
+// Decodes every image found in the pages directory (bench/pages by default,
+// or --pages DIR). The directory is not part of the repository; fill it with
+// `make -f Makefile.host pages` (synthetic pages, see tools/pagegen.cpp) or
+// with real chapter pages before running. Cases are named after the decoder
+// backend that takes each file (decoder.h), e.g. decode/webp/page-003.webp
+// in a WEBP=1 build; backend totals are printed after the group.
+
+#include "bench.h"
+#include "decoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <dirent.h>
+
+bool benchReadFile(const std::string &path, std::vector<uint8_t> &out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  out.resize(size > 0 ? size : 0);
+  bool ok = fread(out.data(), 1, out.size(), f) == out.size();
+  fclose(f);
+  return ok && !out.empty();
+}
+
+std::vector<std::string> benchPageFiles(const std::string &dir) {
+  std::vector<std::string> files;
+  if (DIR *d = opendir(dir.c_str())) {
+    while (dirent *e = readdir(d))
+      if (e->d_name[0] != '.')
+        files.push_back(e->d_name);
+    closedir(d);
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+static void decodeGroup(BenchSuite &suite) {
+  std::vector<std::string> files = benchPageFiles(suite.pagesDir);
+  if (files.empty()) {
+    fprintf(stderr, "decode: no sample pages in %s, skipping\n",
+            suite.pagesDir.c_str());
+    return;
+  }
+
+  for (const std::string &file : files) {
+    std::vector<uint8_t> data;
+    if (!benchReadFile(suite.pagesDir + "/" + file, data))
+      continue;
+    DecodedImage probe;
+    if (!decodeImage(data.data(), data.size(), probe))
+      continue;
+
+    // Throughput is reported against the decoded RGBA size
+    std::string name = decoderName(data.data(), data.size());
+    suite.measure("decode/" + name + "/" + file, (size_t)probe.w * probe.h * 4,
+                  [&] {
+                    DecodedImage img;
+                    decodeImage(data.data(), data.size(), img);
+                  });
+  }
+  decoderReport();
+}
+BENCH_GROUP("decode", decodeGroup);
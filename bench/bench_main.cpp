@@ -0,0 +1,142 @@
+// KatanaReaderNX – host micro-benchmark runner
+//
+//   make -f Makefile.host bench
+//   build_host/bench [--filter blit/] [--min-time 500] [--json out.json]
+//                    [--pages DIR]
+//
+// Results are printed as a table and, with --json, written out with
+// nlohmann/json so two runs can be diffed or plotted.
+
+#include "bench.h"
+#include "alloc.h"
+#include "platform.h"
+#include "nlohmann/json.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Allocation counting
+// alloc.cpp's malloc hooks see everything, including operator new, libcurl
+// and stb_image.
+// ─────────────────────────────────────────────────────────────────────────────
+uint64_t benchAllocCount() { return allocTotalCount(); }
+uint64_t benchAllocBytes() { return allocTotalBytes(); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Platform
+// The reader modules linked in here only need the clock from platform.h.
+// ─────────────────────────────────────────────────────────────────────────────
+uint64_t platformNowNs() { return BenchSuite::nowNs(); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Registry
+// ─────────────────────────────────────────────────────────────────────────────
+struct BenchGroup {
+  const char *name;
+  BenchGroupFn fn;
+};
+
+static std::vector<BenchGroup> &groups() {
+  static std::vector<BenchGroup> g;
+  return g;
+}
+
+BenchRegistrar::BenchRegistrar(const char *group, BenchGroupFn fn) {
+  groups().push_back({group, fn});
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// BenchSuite
+// ─────────────────────────────────────────────────────────────────────────────
+uint64_t BenchSuite::nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+bool BenchSuite::parseArgs(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--filter") && hasValue) {
+      filter = argv[++i];
+    } else if (!strcmp(argv[i], "--min-time") && hasValue) {
+      minTimeNs = strtoull(argv[++i], nullptr, 10) * 1000000ull;
+    } else if (!strcmp(argv[i], "--json") && hasValue) {
+      jsonPath = argv[++i];
+    } else if (!strcmp(argv[i], "--pages") && hasValue) {
+      pagesDir = argv[++i];
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BenchSuite::selected(const std::string &name) const {
+  return filter.empty() || name.find(filter) != std::string::npos;
+}
+
+void BenchSuite::fail(const std::string &why) {
+  fprintf(stderr, "FAILED: %s\n", why.c_str());
+  failed = true;
+}
+
+void BenchSuite::record(const std::string &name, size_t bytesPerOp,
+                        uint64_t iters, uint64_t elapsedNs, uint64_t allocs,
+                        uint64_t allocBytes) {
+  Result r;
+  r.name = name;
+  r.iterations = iters;
+  r.nsPerOp = (double)elapsedNs / iters;
+  r.mbPerSec = bytesPerOp ? bytesPerOp / r.nsPerOp * 1e3 : 0.0;
+  r.allocsPerOp = (double)allocs / iters;
+  r.allocBytesPerOp = (double)allocBytes / iters;
+  all.push_back(r);
+
+  printf("%-44s %14.1f %10.1f %10.2f %12.0f\n", name.c_str(), r.nsPerOp,
+         r.mbPerSec, r.allocsPerOp, r.allocBytesPerOp);
+  fflush(stdout);
+}
+
+bool BenchSuite::writeJson(const std::string &path) const {
+  nlohmann::json j;
+  j["suite"] = "KatanaReaderNX";
+  j["timestamp"] = (int64_t)time(nullptr);
+  j["min_time_ms"] = minTimeNs / 1000000;
+  j["results"] = nlohmann::json::array();
+  for (const Result &r : all)
+    j["results"].push_back({{"name", r.name},
+                            {"iterations", r.iterations},
+                            {"ns_per_op", r.nsPerOp},
+                            {"mb_per_s", r.mbPerSec},
+                            {"allocs_per_op", r.allocsPerOp},
+                            {"alloc_bytes_per_op", r.allocBytesPerOp}});
+  std::ofstream out(path);
+  out << j.dump(2) << "\n";
+  return (bool)out;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Main
+// ─────────────────────────────────────────────────────────────────────────────
+int main(int argc, char *argv[]) {
+  BenchSuite suite;
+  if (!suite.parseArgs(argc, argv))
+    return 2;
+
+  printf("%-44s %14s %10s %10s %12s\n", "benchmark", "ns/op", "MB/s",
+         "allocs/op", "bytes/op");
+  for (const BenchGroup &g : groups())
+    g.fn(suite);
+
+  if (!suite.jsonPath.empty() && !suite.writeJson(suite.jsonPath)) {
+    fprintf(stderr, "cannot write %s\n", suite.jsonPath.c_str());
+    return 1;
+  }
+  return suite.failed ? 1 : 0;
+}
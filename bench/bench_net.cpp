@@ -0,0 +1,35 @@
+// KatanaReaderNX – benchmarks: libcurl write callbacks
+// Feeds bodies through the callbacks in 16 KiB chunks (CURL_MAX_WRITE_SIZE),
+// the way libcurl delivers them, without touching the network.
+
+#include "bench.h"
+#include "net.h"
+#include <cstdio>
+
+static const size_t CHUNK = 16 * 1024;
+
+static void netGroup(BenchSuite &suite) {
+  std::vector<uint8_t> body(4 * 1024 * 1024);
+  for (size_t i = 0; i < body.size(); i++)
+    body[i] = (uint8_t)(i * 31);
+
+  for (size_t size : {128 * 1024, 1024 * 1024, 4 * 1024 * 1024}) {
+    char name[64];
+    snprintf(name, sizeof(name), "net/write-bin/%zuKiB", size / 1024);
+    suite.measure(name, size, [&] {
+      MemoryBuffer buf;
+      for (size_t off = 0; off < size; off += CHUNK)
+        WriteCallbackBin(body.data() + off, 1, std::min(CHUNK, size - off),
+                         &buf);
+    });
+  }
+
+  size_t htmlSize = 128 * 1024;
+  suite.measure("net/write-str/128KiB", htmlSize, [&] {
+    std::string html;
+    for (size_t off = 0; off < htmlSize; off += CHUNK)
+      WriteCallbackStr(body.data() + off, 1, std::min(CHUNK, htmlSize - off),
+                       &html);
+  });
+}
+BENCH_GROUP("net", netGroup);
@@ -0,0 +1,43 @@
+// KatanaReaderNX – benchmarks: chapter HTML parsing
+
+#include "bench.h"
+#include "chapter.h"
+#include <cstdio>
+
+// A reader page shaped like MangaKatana's: a lot of unrelated markup and
+// script, a few decoy arrays, then the image array near the end.
+static std::string syntheticChapterHtml(int pages) {
+  std::string html = "<!DOCTYPE html><html><head><title>Solo Leveling "
+                     "Chapter 200</title>\n";
+  for (int i = 0; i < 400; i++) {
+    char line[160];
+    snprintf(line, sizeof(line),
+             "<div class=\"item\" id=\"n%d\"><a href=\"/manga/x.%d\">"
+             "Chapter %d</a><span class=\"date\">Jan-%02d-2024</span></div>\n",
+             i, i, i, i % 28 + 1);
+    html += line;
+  }
+  html += "<script>var ads = ['a', 'b', 'c'];\n"
+          "var thumbs = ['https://cdn.example.com/t1.jpg'];\n";
+  html += "var ytaw=[";
+  for (int i = 0; i < pages; i++) {
+    char url[128];
+    snprintf(url, sizeof(url),
+             "'https://i3.mangakatana.com/imgs/solo-leveling/c200/%03d.jpg',",
+             i + 1);
+    html += url;
+  }
+  html += "];\n</script></body></html>\n";
+  return html;
+}
+
+static void parseGroup(BenchSuite &suite) {
+  for (int pages : {20, 60, 200}) {
+    std::string html = syntheticChapterHtml(pages);
+    char name[64];
+    snprintf(name, sizeof(name), "parse/mangakatana/%d-pages", pages);
+    suite.measure(name, html.size(),
+                  [&] { extractMangaKatanaImages(html); });
+  }
+}
+BENCH_GROUP("parse", parseGroup);
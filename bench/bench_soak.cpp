@@ -0,0 +1,184 @@
+// KatanaReaderNX – benchmarks: pixel pool soak
+// Loads 1000 pages the way the reader's page cache does at the normal memory
+// level – download, decode, crop, fit to the screen, pack, and keep each tier
+// for its window of recent pages – once with the pixel pool and once without
+// it. Each run tracks the heap footprint: everything malloc has taken from
+// the system, free holes included, which is what fragmentation grows. Fails
+// the run (exit 1) if the footprint with the pool after 1000 loads is more
+// than 1 MB above its footprint after the first 300, or if it grew no less
+// than the footprint without the pool did.
+//
+// Both runs keep every block on one heap, as newlib does on the Switch, and
+// start from the same heap in a child process of their own. The pool run's
+// footprint includes the slabs reserved up front, so the runs are compared
+// on growth after the warm-up rather than on size.
+//
+// Uses the pages directory like the decode benchmarks, or a few synthetic
+// PPM pages of typical scan sizes when it is empty.
+
+#include "bench.h"
+#include "decoder.h"
+#include "pixelpool.h"
+#include "render.h"
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <malloc.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const int SOAK_LOADS = 1000;
+static const int SOAK_WARMUP = 300;
+static const size_t SOAK_SLACK = 1u << 20;
+static const size_t SOAK_POOL = 108u << 20;
+
+// Pages kept in each tier of the page cache at the normal level (main.cpp,
+// memory.cpp): decoded, packed and encoded
+static const int SOAK_HOT = 7, SOAK_WARM = 17, SOAK_COLD = 33;
+static const size_t SOAK_CHUNK = 16384; // curl's write callback size
+
+static size_t heapFootprint() {
+  struct mallinfo2 mi = mallinfo2();
+  return mi.arena + mi.hblkhd;
+}
+
+static std::vector<uint8_t> syntheticPage(int w, int h, int seed) {
+  char header[32];
+  int n = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", w, h);
+  std::vector<uint8_t> ppm(header, header + n);
+  ppm.resize(n + (size_t)w * h * 3);
+  for (int y = 0; y < h; y++)
+    for (int x = 0; x < w; x++) {
+      uint8_t v = (uint8_t)((x / 40 + y / 40 + seed) % 2 ? 235 : 30);
+      uint8_t *p = &ppm[n + ((size_t)y * w + x) * 3];
+      p[0] = p[1] = p[2] = v;
+    }
+  return ppm;
+}
+
+struct SoakResult {
+  size_t warmPeak, peak; // footprint after the warm-up, and after every load
+  double msPerLoad;
+  PixelPoolStats pool;
+};
+
+static SoakResult soakLoads(const std::vector<std::vector<uint8_t>> &pages,
+                            const char *name) {
+  std::deque<DecodedImage *> hot;
+  std::deque<std::vector<uint8_t>> warm, cold;
+  SoakResult r = {};
+  uint64_t start = BenchSuite::nowNs();
+  for (int i = 0; i < SOAK_LOADS; i++) {
+    // The download grows chunk by chunk, like net.cpp's buffer
+    const std::vector<uint8_t> &page = pages[i % pages.size()];
+    std::vector<uint8_t> data;
+    for (size_t at = 0; at < page.size(); at += SOAK_CHUNK)
+      data.insert(data.end(), page.begin() + at,
+                  page.begin() + std::min(page.size(), at + SOAK_CHUNK));
+
+    auto *di = new DecodedImage();
+    if (decodeImage(data.data(), data.size(), *di)) {
+      cropMargins(*di);
+      fitToScreen(*di);
+    }
+    // Packed pages come out at about a quarter of the pixels' size
+    warm.emplace_back((size_t)di->w * di->h + i % 4096);
+    cold.push_back(std::move(data));
+    hot.push_back(di);
+    if ((int)hot.size() > SOAK_HOT) {
+      delete hot.front();
+      hot.pop_front();
+    }
+    if ((int)warm.size() > SOAK_WARM)
+      warm.pop_front();
+    if ((int)cold.size() > SOAK_COLD)
+      cold.pop_front();
+
+    r.peak = std::max(r.peak, heapFootprint());
+    if (i + 1 == SOAK_WARMUP)
+      r.warmPeak = r.peak;
+    if ((i + 1) % 200 == 0)
+      printf("soak/%-10s/%-20d heap footprint %6.1f MB, pool peak %5.1f MB\n",
+             name, i + 1, r.peak / 1048576.0,
+             pixelPoolStats().peakInUse / 1048576.0);
+  }
+  r.msPerLoad = (BenchSuite::nowNs() - start) / 1e6 / SOAK_LOADS;
+  for (auto *p : hot)
+    delete p;
+  r.pool = pixelPoolStats();
+  printf("soak/%s: %.2f ms per load, %llu slab / %llu fallback allocations\n",
+         name, r.msPerLoad, (unsigned long long)r.pool.slabAllocs,
+         (unsigned long long)r.pool.fallbackAllocs);
+  return r;
+}
+
+// Run the loads in a child process; false if it didn't report back.
+static bool soakRun(const std::vector<std::vector<uint8_t>> &pages,
+                    size_t poolBytes, const char *name, SoakResult &r) {
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    mallopt(M_MMAP_MAX, 0);
+    pixelPoolInit(poolBytes);
+    SoakResult child = soakLoads(pages, name);
+    fflush(stdout);
+    _exit(write(fds[1], &child, sizeof(child)) == sizeof(child) ? 0 : 1);
+  }
+  close(fds[1]);
+  bool ok = pid > 0 && read(fds[0], &r, sizeof(r)) == sizeof(r);
+  close(fds[0]);
+  int status = 0;
+  if (pid > 0)
+    waitpid(pid, &status, 0);
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void soakGroup(BenchSuite &suite) {
+  if (!suite.selected("soak/pixel-pool"))
+    return;
+  std::vector<std::vector<uint8_t>> pages;
+  for (const std::string &file : benchPageFiles(suite.pagesDir)) {
+    std::vector<uint8_t> data;
+    if (benchReadFile(suite.pagesDir + "/" + file, data))
+      pages.push_back(std::move(data));
+  }
+  if (pages.empty()) {
+    static const int SIZES[][2] = {{960, 1400},  {1600, 2400}, {720, 1100},
+                                   {1200, 1700}, {840, 1250},  {1440, 2000},
+                                   {1080, 1560}};
+    int seed = 0;
+    for (const auto &size : SIZES)
+      pages.push_back(syntheticPage(size[0], size[1], seed++));
+  }
+
+  SoakResult pool, noPool;
+  if (!soakRun(pages, SOAK_POOL, "pixel-pool", pool) ||
+      !soakRun(pages, 0, "no-pool", noPool)) {
+    suite.fail("soak/pixel-pool run did not finish");
+    return;
+  }
+  size_t poolGrowth = pool.peak - pool.warmPeak;
+  size_t noPoolGrowth = noPool.peak - noPool.warmPeak;
+  printf("soak/pixel-pool: footprint grew %.1f MB with the pool, %.1f MB "
+         "without\n",
+         poolGrowth / 1048576.0, noPoolGrowth / 1048576.0);
+  char why[128];
+  if (poolGrowth > SOAK_SLACK) {
+    snprintf(why, sizeof(why),
+             "soak/pixel-pool heap footprint grew from %.1f MB to %.1f MB",
+             pool.warmPeak / 1048576.0, pool.peak / 1048576.0);
+    suite.fail(why);
+  }
+  if (poolGrowth >= noPoolGrowth) {
+    snprintf(why, sizeof(why),
+             "soak/pixel-pool heap footprint grew %.1f MB, no less than "
+             "%.1f MB without the pool",
+             poolGrowth / 1048576.0, noPoolGrowth / 1048576.0);
+    suite.fail(why);
+  }
+}
+BENCH_GROUP("soak", soakGroup);
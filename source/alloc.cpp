@@ -0,0 +1,161 @@
+// KatanaReaderNX – allocation tracker
+// See alloc.h.
+
+#include "alloc.h"
+#ifdef KATANA_ALLOC_TRACK
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Counters
+// Everything touched from the hooks is constant-initialised: the hooks run
+// before static constructors and must never allocate themselves.
+// ─────────────────────────────────────────────────────────────────────────────
+static const int MAX_STAGES = 16;
+
+struct StageCounts {
+  const char *name;
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> bytes;
+};
+
+static StageCounts stages[MAX_STAGES];
+static std::atomic<int> stageCount{0};
+static std::mutex stageMtx; // registration only
+
+static std::atomic<uint64_t> totalCount{0};
+static std::atomic<uint64_t> totalBytes{0};
+static thread_local uint64_t threadCount = 0;
+static thread_local int threadStage = -1;
+
+static inline void recordAlloc(size_t n) {
+  totalCount.fetch_add(1, std::memory_order_relaxed);
+  totalBytes.fetch_add(n, std::memory_order_relaxed);
+  threadCount++;
+  if (threadStage >= 0) {
+    stages[threadStage].count.fetch_add(1, std::memory_order_relaxed);
+    stages[threadStage].bytes.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+extern "C" {
+void *__libc_malloc(size_t n);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t n);
+
+void *malloc(size_t n) {
+  recordAlloc(n);
+  return __libc_malloc(n);
+}
+
+void *calloc(size_t n, size_t size) {
+  recordAlloc(n * size);
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t n) {
+  recordAlloc(n);
+  return __libc_realloc(p, n);
+}
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Stages
+// ─────────────────────────────────────────────────────────────────────────────
+static int stageIndex(const char *name) {
+  int n = stageCount.load(std::memory_order_acquire);
+  for (int i = 0; i < n; i++)
+    if (strcmp(stages[i].name, name) == 0)
+      return i;
+
+  std::lock_guard<std::mutex> lock(stageMtx);
+  n = stageCount.load(std::memory_order_relaxed);
+  for (int i = 0; i < n; i++)
+    if (strcmp(stages[i].name, name) == 0)
+      return i;
+  if (n == MAX_STAGES)
+    return -1;
+  stages[n].name = name;
+  stageCount.store(n + 1, std::memory_order_release);
+  return n;
+}
+
+AllocStage::AllocStage(const char *name) : prev(threadStage) {
+  threadStage = stageIndex(name);
+}
+
+AllocStage::~AllocStage() { threadStage = prev; }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Main loop frames
+// ─────────────────────────────────────────────────────────────────────────────
+struct FrameAllocs {
+  int warmup = -1; // -1: steady-state check off
+  uint64_t frames = 0;
+  uint64_t lastCount = 0;
+  uint64_t allocatingFrames = 0, worst = 0;
+  uint64_t violations = 0, firstViolation = 0, firstViolationCount = 0;
+};
+
+static FrameAllocs frameAllocs;
+
+void allocCheckSteadyState(int warmupFrames) {
+  frameAllocs.warmup = warmupFrames;
+}
+
+void allocFrame() {
+  FrameAllocs &f = frameAllocs;
+  uint64_t n = threadCount - f.lastCount;
+  f.lastCount = threadCount;
+  if (f.frames++ == 0)
+    return; // everything before the first iteration is start-up
+
+  if (n == 0)
+    return;
+  f.allocatingFrames++;
+  if (n > f.worst)
+    f.worst = n;
+  if (f.warmup >= 0 && f.frames > (uint64_t)f.warmup + 1) {
+    if (f.violations++ == 0) {
+      f.firstViolation = f.frames - 1;
+      f.firstViolationCount = n;
+    }
+  }
+}
+
+uint64_t allocTotalCount() { return totalCount.load(); }
+uint64_t allocTotalBytes() { return totalBytes.load(); }
+
+bool allocReport() {
+  const FrameAllocs &f = frameAllocs;
+  printf("[alloc] %llu allocations, %llu bytes in total\n",
+         (unsigned long long)totalCount.load(),
+         (unsigned long long)totalBytes.load());
+  int n = stageCount.load(std::memory_order_acquire);
+  for (int i = 0; i < n; i++)
+    printf("[alloc]   %-10s %8llu allocations %12llu bytes\n", stages[i].name,
+           (unsigned long long)stages[i].count.load(),
+           (unsigned long long)stages[i].bytes.load());
+  uint64_t loopFrames = f.frames ? f.frames - 1 : 0;
+  printf("[alloc] main loop: %llu of %llu iterations allocated (worst %llu)\n",
+         (unsigned long long)f.allocatingFrames,
+         (unsigned long long)loopFrames, (unsigned long long)f.worst);
+
+  if (f.warmup < 0)
+    return true;
+  if (f.violations == 0) {
+    printf("[alloc] zero-allocation check passed after %d warm-up frames\n",
+           f.warmup);
+    return true;
+  }
+  printf("[alloc] zero-allocation check FAILED: %llu iterations allocated "
+         "after warm-up, first at iteration %llu (%llu allocations)\n",
+         (unsigned long long)f.violations,
+         (unsigned long long)f.firstViolation,
+         (unsigned long long)f.firstViolationCount);
+  return false;
+}
+#endif
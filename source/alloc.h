@@ -0,0 +1,55 @@
+// KatanaReaderNX – allocation tracker
+// Counts heap allocations per thread, per pipeline stage and per main loop
+// iteration, so allocations creeping into the render loop show up before
+// they turn into stutters or allocation failures on the Switch's fragmented
+// heap.
+//
+// Only host builds track allocations (malloc, calloc and realloc are
+// interposed; operator new goes through malloc). On the Switch the macros
+// expand to nothing.
+
+#pragma once
+#include <cstdint>
+
+#ifndef __SWITCH__
+#define KATANA_ALLOC_TRACK
+#endif
+
+#ifdef KATANA_ALLOC_TRACK
+
+// Attribute the calling thread's allocations to `name` until the end of the
+// scope. Names must be string literals; stages nest.
+struct AllocStage {
+  explicit AllocStage(const char *name);
+  ~AllocStage();
+  int prev;
+};
+
+// Fail the run when any main loop iteration after the first `warmupFrames`
+// allocates on the main thread (host --zero-alloc).
+void allocCheckSteadyState(int warmupFrames);
+
+// Close one main loop iteration; called at the top of every iteration.
+void allocFrame();
+
+// Allocations made, and bytes requested, on all threads since start-up.
+uint64_t allocTotalCount();
+uint64_t allocTotalBytes();
+
+// Print the totals, per-stage counts and the per-frame summary. Returns false
+// if the steady-state check was enabled and failed.
+bool allocReport();
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_STAGE(name) AllocStage ALLOC_CONCAT(allocStage_, __LINE__)(name)
+#define ALLOC_FRAME() allocFrame()
+#define ALLOC_REPORT() allocReport()
+
+#else
+
+#define ALLOC_STAGE(name) ((void)0)
+#define ALLOC_FRAME() ((void)0)
+#define ALLOC_REPORT() true
+
+#endif
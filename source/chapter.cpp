@@ -0,0 +1,42 @@
+// KatanaReaderNX – chapter page list
+// See chapter.h.
+
+#include "chapter.h"
+#include <regex>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// HTML parser – pull image URLs out of MangaKatana JS arrays
+// ─────────────────────────────────────────────────────────────────────────────
+std::vector<std::string> chapterImages;
+std::string chapterBaseUrl = "https://mangakatana.com";
+
+std::string chapterUrl() {
+  return chapterBaseUrl + "/manga/solo-leveling.16520/c200";
+}
+
+bool extractMangaKatanaImages(const std::string &html) {
+  chapterImages.clear();
+  std::string localImgs = chapterBaseUrl + "/imgs/";
+  std::regex arrayRx(R"(var\s+[a-zA-Z_]\w*\s*=\s*\[(.*?)\];)");
+  std::smatch m;
+  auto it = html.cbegin();
+  while (std::regex_search(it, html.cend(), m, arrayRx)) {
+    std::string arr = m[1];
+    if (arr.find("imgs") != std::string::npos) {
+      std::regex urlRx(R"('(https?://[^']+)')");
+      std::smatch um;
+      auto ui = arr.cbegin();
+      while (std::regex_search(ui, arr.cend(), um, urlRx)) {
+        std::string url = um[1];
+        if (url.find("mangakatana.com/imgs") != std::string::npos ||
+            url.compare(0, localImgs.size(), localImgs) == 0)
+          chapterImages.push_back(url);
+        ui = um.suffix().first;
+      }
+      if (!chapterImages.empty())
+        return true;
+    }
+    it = m.suffix().first;
+  }
+  return false;
+}
@@ -0,0 +1,21 @@
+// KatanaReaderNX – chapter page list
+// Image URLs for the open chapter, scraped from the MangaKatana reader page.
+
+#pragma once
+#include <string>
+#include <vector>
+
+extern std::vector<std::string> chapterImages;
+
+// Site the chapter is read from, without a trailing slash. The host build
+// can point it at a local stand-in server (--base-url, see
+// tools/standin_server.cpp).
+extern std::string chapterBaseUrl;
+
+// Reader page of the open chapter on chapterBaseUrl
+std::string chapterUrl();
+
+// Fill chapterImages from the chapter HTML. False if no image array is found.
+// Image URLs are accepted on MangaKatana's image hosts or under
+// chapterBaseUrl/imgs/.
+bool extractMangaKatanaImages(const std::string &html);
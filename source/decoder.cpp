@@ -0,0 +1,170 @@
+// KatanaReaderNX – image decoder backends
+// See decoder.h.
+
+#include "decoder.h"
+#include "pixelpool.h"
+#include "platform.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#ifdef HAVE_WEBP
+#include <webp/decode.h>
+#endif
+
+// Bytes requested from the pixel pool by the decode running on this thread
+static thread_local size_t decodeAllocated = 0;
+
+static void *decoderAlloc(size_t size) {
+  decodeAllocated += size;
+  return pixelAlloc(size);
+}
+
+static void *decoderRealloc(void *p, size_t size) {
+  decodeAllocated += size;
+  return pixelRealloc(p, size);
+}
+
+// stb_image draws every buffer from the pixel pool, counted per decode
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_MALLOC(size) decoderAlloc(size)
+#define STBI_REALLOC(p, size) decoderRealloc(p, size)
+#define STBI_FREE(p) pixelFree(p)
+#include "stb_image.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Backends
+// Each one returns RGBA8 pixels from the pixel pool, or nullptr.
+// ─────────────────────────────────────────────────────────────────────────────
+static bool isWebp(const uint8_t *data, size_t size) {
+  return size >= 12 && !memcmp(data, "RIFF", 4) && !memcmp(data + 8, "WEBP", 4);
+}
+
+#ifdef HAVE_WEBP
+static bool infoWebp(const uint8_t *data, size_t size, int &w, int &h) {
+  return WebPGetInfo(data, size, &w, &h);
+}
+
+static uint8_t *decodeWebp(const uint8_t *data, size_t size, int &w, int &h) {
+  if (!WebPGetInfo(data, size, &w, &h))
+    return nullptr;
+  size_t bytes = (size_t)w * h * 4;
+  auto *pixels = (uint8_t *)decoderAlloc(bytes);
+  if (pixels && !WebPDecodeRGBAInto(data, size, pixels, bytes, w * 4)) {
+    pixelFree(pixels);
+    pixels = nullptr;
+  }
+  return pixels;
+}
+#endif
+
+static bool anyFormat(const uint8_t *, size_t) { return true; }
+
+static bool infoStb(const uint8_t *data, size_t size, int &w, int &h) {
+  int channels;
+  return size <= INT_MAX &&
+         stbi_info_from_memory(data, (int)size, &w, &h, &channels);
+}
+
+static uint8_t *decodeStb(const uint8_t *data, size_t size, int &w, int &h) {
+  if (size > INT_MAX)
+    return nullptr;
+  int channels;
+  return stbi_load_from_memory(data, (int)size, &w, &h, &channels, 4);
+}
+
+struct Backend {
+  const char *name;
+  bool (*sniff)(const uint8_t *data, size_t size);
+  bool (*info)(const uint8_t *data, size_t size, int &w, int &h);
+  uint8_t *(*decode)(const uint8_t *data, size_t size, int &w, int &h);
+};
+
+// First match wins; stb takes whatever is left
+static const Backend BACKENDS[] = {
+#ifdef HAVE_WEBP
+    {"webp", isWebp, infoWebp, decodeWebp},
+#endif
+    {"stb", anyFormat, infoStb, decodeStb},
+};
+static const int BACKEND_COUNT = sizeof(BACKENDS) / sizeof(BACKENDS[0]);
+
+static int backendFor(const uint8_t *data, size_t size) {
+  int b = 0;
+  while (!BACKENDS[b].sniff(data, size))
+    b++;
+  return b;
+}
+
+const char *decoderName(const uint8_t *data, size_t size) {
+  return BACKENDS[backendFor(data, size)].name;
+}
+
+bool decoderInfo(const uint8_t *data, size_t size, int &w, int &h) {
+  return BACKENDS[backendFor(data, size)].info(data, size, w, h);
+}
+
+const char *decoderAccept() {
+#ifdef HAVE_WEBP
+  return "image/webp,image/jpeg,image/png,*/*;q=0.5";
+#else
+  return "image/jpeg,image/png,image/gif,*/*;q=0.5";
+#endif
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decoding and counters
+// ─────────────────────────────────────────────────────────────────────────────
+struct BackendStats {
+  uint64_t pages, failures, ns;
+  uint64_t bytesIn, bytesOut;
+  size_t peakAllocated; // most requested from the pool by one decode
+};
+
+static std::mutex statsMtx; // decodes run on the cache and start-up workers
+static BackendStats stats[BACKEND_COUNT];
+static bool webpHinted = false; // the WEBP=1 hint is printed once
+
+bool decodeImage(const uint8_t *data, size_t size, DecodedImage &img) {
+  int b = backendFor(data, size);
+  decodeAllocated = 0;
+  uint64_t start = platformNowNs();
+  img.pixels = BACKENDS[b].decode(data, size, img.w, img.h);
+  uint64_t ns = platformNowNs() - start;
+
+  bool ok = img.pixels != nullptr;
+  bool hint = false;
+  {
+    std::lock_guard<std::mutex> lock(statsMtx);
+    BackendStats &s = stats[b];
+    s.pages++;
+    s.ns += ns;
+    s.bytesIn += size;
+    if (ok)
+      s.bytesOut += (uint64_t)img.w * img.h * 4;
+    else
+      s.failures++;
+    if (!ok && !webpHinted && isWebp(data, size))
+      webpHinted = hint = true;
+    if (decodeAllocated > s.peakAllocated)
+      s.peakAllocated = decodeAllocated;
+  }
+  if (hint)
+    printf("[decode] page is WebP, which needs a build with WEBP=1\n");
+  return ok;
+}
+
+void decoderReport() {
+  std::lock_guard<std::mutex> lock(statsMtx);
+  for (int b = 0; b < BACKEND_COUNT; b++) {
+    const BackendStats &s = stats[b];
+    if (!s.pages)
+      continue;
+    printf("[decode] %-4s %llu pages (%llu failed), %.1f ms avg, %.1f MB in, "
+           "%.1f MB out, up to %.1f MB allocated per page\n",
+           BACKENDS[b].name, (unsigned long long)s.pages,
+           (unsigned long long)s.failures, s.ns / 1e6 / s.pages,
+           s.bytesIn / 1048576.0, s.bytesOut / 1048576.0,
+           s.peakAllocated / 1048576.0);
+  }
+}
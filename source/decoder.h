@@ -0,0 +1,31 @@
+// KatanaReaderNX – image decoder backends
+// Pages are decoded by whichever backend claims the file's magic bytes:
+// libwebp for WebP in builds with HAVE_WEBP (make WEBP=1), and stb_image for
+// everything else (JPEG, PNG, GIF, BMP, PNM). Many image CDNs serve WebP at
+// a third fewer bytes than JPEG, but only to clients that ask for it, so
+// downloads advertise the formats this build can decode (decoderAccept).
+//
+// Every backend decodes to RGBA8 in a pixel pool buffer (pixelpool.h) and
+// counts its pages, decode time and memory for decoderReport.
+
+#pragma once
+#include "render.h"
+#include <cstddef>
+#include <cstdint>
+
+// Name of the backend that takes `data` ("webp", "stb").
+const char *decoderName(const uint8_t *data, size_t size);
+
+// Size of the image from its header alone, without decoding; false if the
+// backend can't read one. Thread-safe.
+bool decoderInfo(const uint8_t *data, size_t size, int &w, int &h);
+
+// Decode into `img`; false if the data is damaged or in a format this build
+// can't decode. Thread-safe.
+bool decodeImage(const uint8_t *data, size_t size, DecodedImage &img);
+
+// HTTP Accept header value for page downloads.
+const char *decoderAccept();
+
+// Print each backend's counters (nothing for backends that weren't used).
+void decoderReport();
@@ -0,0 +1,73 @@
+// KatanaReaderNX – on-screen performance HUD
+// See hud.h.
+
+#include "hud.h"
+#include "memory.h"
+#include "stats.h"
+#include "text.h"
+#include <cstdio>
+#include <cstring>
+
+// Layout in portrait coordinates (see text.h)
+static const int PAD = 8;
+static const int BOX_W = 330;
+static const int LINES = 5;
+static const uint64_t REFRESH_NS = 250000000ull;
+
+static bool visible = false;
+static bool toggled = false;
+static uint64_t lastRefresh = 0;
+static char text[LINES][64];
+
+static int boxHeight() { return LINES * textLineHeight() + 2 * PAD; }
+
+bool hudInit() { return textReady() || textInit(); }
+
+void hudToggle() {
+  if (!textReady())
+    return;
+  visible = !visible;
+  toggled = true;
+  lastRefresh = 0;
+}
+
+bool hudVisible() { return visible; }
+
+bool hudUpdate(uint64_t nowNs) {
+  bool dirty = toggled;
+  toggled = false;
+  if (!visible || nowNs - lastRefresh < REFRESH_NS)
+    return dirty;
+  lastRefresh = nowNs;
+
+  StatsSnapshot s = statsSnapshot(nowNs);
+  char next[LINES][64];
+  snprintf(next[0], sizeof(next[0]), "FPS %.0f", s.fps);
+  snprintf(next[1], sizeof(next[1]), "frame p50 %.1f ms  p99 %.1f ms",
+           s.frameP50Ms, s.frameP99Ms);
+  snprintf(next[2], sizeof(next[2]), "decode %.1f ms", s.decodeMs);
+  snprintf(next[3], sizeof(next[3]), "net %.0f KB/s  cache hit %.0f%%",
+           s.netKBps, s.cacheHitRate * 100.0f);
+  snprintf(next[4], sizeof(next[4]), "mem %.1f MB (%s)",
+           s.memUsed / 1048576.0, memoryLevelName());
+  if (memcmp(next, text, sizeof(text)) != 0) {
+    memcpy(text, next, sizeof(text));
+    dirty = true;
+  }
+  return dirty;
+}
+
+Rect hudRect() { return portraitRect(0, 0, BOX_W, boxHeight()); }
+
+Rect hudDraw(uint32_t *fb) {
+  if (!visible)
+    return {0, 0, 0, 0};
+
+  // Darken the page underneath so the text stays readable
+  Rect box = hudRect();
+  shadeRect(fb, box, rgba8(0, 0, 0, 255), 160);
+  for (int i = 0; i < LINES; i++)
+    textDraw(fb, PAD, PAD + i * textLineHeight(), text[i],
+             rgba8(255, 255, 255, 255), box);
+  return box;
+}
@@ -0,0 +1,25 @@
+// KatanaReaderNX – on-screen performance HUD
+// A small overlay in the top-left corner (as the Switch is held in portrait)
+// showing FPS, frame-time percentiles, decode time, network throughput, cache
+// hit rate and memory in use, drawn with the glyph atlas from text.h.
+
+#pragma once
+#include "render.h"
+#include <cstdint>
+
+// Returns false (and the HUD stays unavailable) when there is no font.
+bool hudInit();
+
+void hudToggle();
+bool hudVisible();
+
+// Refresh the text from the stats a few times per second. Returns true when
+// the overlay has to be redrawn (text changed or visibility toggled).
+bool hudUpdate(uint64_t nowNs);
+
+// Framebuffer area the overlay covers when visible.
+Rect hudRect();
+
+// Draw the overlay over whatever is in `fb` and return the area touched
+// (empty when hidden).
+Rect hudDraw(uint32_t *fb);
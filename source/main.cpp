@@ -1,286 +1,943 @@
 // KatanaReaderNX – Native libnx Framebuffer Manga Reader
-// Uses stb_image.h for JPEG decoding (zero extra dependencies)
-// and libnx framebufferCreate for rendering in portrait mode.
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+// Decodes pages with stb_image.h, and libwebp in WEBP=1 builds (decoder.h),
+// and uses libnx framebufferCreate for rendering in portrait mode.
+// All system access goes through platform.h so the reader also builds and
+// runs headless on Linux (see Makefile.host).
+
+#include "alloc.h"
+#include "chapter.h"
+#include "decoder.h"
+#include "hud.h"
+#include "memory.h"
+#include "net.h"
+#include "pixelpool.h"
+#include "platform.h"
+#include "render.h"
+#include "resume.h"
+#include "session.h"
+#include "snapshot.h"
+#include "startup.h"
+#include "stats.h"
+#include "text.h"
+#include "trace.h"
+#include "writer.h"
 #include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
 #include <curl/curl.h>
-#include <regex>
+#include <mutex>
 #include <string>
-#include <switch.h>
+#include <thread>
 #include <vector>
 
-
 // ─────────────────────────────────────────────────────────────────────────────
-// Display constants
+// Page cache with background prefetch
+// A worker thread downloads and decodes pages inside a window around the
+// current page, nearest first, so scrolling never waits on the network.
+// Pages saved for resuming (resume.h) are loaded from disk instead, and are
+// the only ones loaded until the network is up.
+//
+// Pages are kept in RAM in three tiers, by distance from the current page:
+//   hot   decoded pixels, ready to draw (the prefetch window)
+//   warm  the same pixels packed (snapshot.h), unpacked much faster than a
+//         JPEG decode
+//   cold  the encoded page as downloaded, so it needs no network again
+// A page passes through every tier on its way in, and only drops out of one
+// once it is too far away for that tier. How far each tier reaches, and the
+// resolution pages are kept at, follow the memory budget (memory.h).
+//
+// Tall pages (render.h) are hot without their pixels: the worker decodes
+// the tiles near the viewport from the page's warm tier, and the main thread
+// installs them and frees the ones left behind as the strip scrolls.
+//
+// Only the main thread ever frees decoded pages, so pointers returned by
+// cacheGet stay valid for the rest of the frame.
 // ─────────────────────────────────────────────────────────────────────────────
-static const int SCREEN_W = 1280;
-static const int SCREEN_H = 720;
+static DecodedImage *decodePage(const std::vector<uint8_t> &data,
+                                float detail) {
+  TRACE_SCOPE("decode");
+  ALLOC_STAGE("decode");
+  uint64_t start = platformNowNs();
+  auto *di = new DecodedImage();
+  if (decodeImage(data.data(), data.size(), *di)) {
+    cropMargins(*di);
+    fitToScreen(*di, detail);
+  }
+  statsDecode(platformNowNs() - start);
+  if (!di->pixels) {
+    delete di;
+    return nullptr;
+  }
+  return di;
+}
 
-// ─────────────────────────────────────────────────────────────────────────────
-// libcurl helpers
-// ─────────────────────────────────────────────────────────────────────────────
-struct MemoryBuffer {
-  std::vector<uint8_t> data;
+struct PageTiers {
+  std::vector<uint8_t> warm; // packed display-ready pixels
+  std::vector<uint8_t> cold; // encoded page as downloaded
 };
 
-size_t WriteCallbackStr(void *c, size_t s, size_t n, void *u) {
-  ((std::string *)u)->append((char *)c, s * n);
-  return s * n;
+// Unpack a warm-tier page, scaled down further when `detail` asks for it.
+static DecodedImage *unpackPage(const std::vector<uint8_t> &packed,
+                                float detail) {
+  DecodedImage *di = snapshotUnpack(packed);
+  if (di && detail < 1.0f)
+    fitToScreen(*di, detail);
+  return di;
 }
-size_t WriteCallbackBin(void *c, size_t s, size_t n, void *u) {
-  auto *b = (MemoryBuffer *)u;
-  uint8_t *p = (uint8_t *)c;
-  b->data.insert(b->data.end(), p, p + s * n);
-  return s * n;
+
+// Decoded pixels for page `idx` from the cheapest source there is: the warm
+// tier, the cold tier, the files saved on disk (`saved`), then the network
+// (when `curl` is set). Tiers that were empty are filled on the way, and new
+// files are kept on disk for resuming. Pages come out scaled to `detail`.
+DecodedImage *loadPage(CURL *curl, int idx, PageTiers &tiers, bool saved,
+                       float detail) {
+  bool fresh = false; // encoded page just read from disk or downloaded
+  if (!tiers.warm.empty()) {
+    if (DecodedImage *di = unpackPage(tiers.warm, detail))
+      return di;
+    tiers.warm.clear();
+  }
+  if (tiers.cold.empty() && saved) {
+    if (snapshotRead(idx, tiers.warm))
+      if (DecodedImage *di = unpackPage(tiers.warm, detail))
+        return di;
+    tiers.warm.clear();
+    fresh = resumeReadPage(idx, tiers.cold);
+  }
+  if (tiers.cold.empty() && curl) {
+    uint64_t start = platformNowNs();
+    {
+      ALLOC_STAGE("download");
+      tiers.cold =
+          downloadRaw(curl, chapterImages[idx], decoderAccept()).data;
+    }
+    if (tiers.cold.empty())
+      return nullptr;
+    statsDownload(tiers.cold.size(), platformNowNs() - start);
+    resumeWritePage(idx, tiers.cold);
+    fresh = true;
+  }
+  if (tiers.cold.empty())
+    return nullptr;
+
+  // Tall pages are decoded whole before they are tiled, as the decoders
+  // can't stop part way down a page; the decoded page and its fitted copy
+  // are charged to the memory budget until the tiles replace them
+  int w, h;
+  size_t transient = 0;
+  if (decoderInfo(tiers.cold.data(), tiers.cold.size(), w, h) &&
+      pageTiled(w, h)) {
+    transient = (size_t)w * h * 4 * 2;
+    memoryCharge(transient);
+  }
+  DecodedImage *di = decodePage(tiers.cold, detail);
+  if (!di) {
+    memoryRelease(transient);
+    tiers.cold.clear();
+    return nullptr;
+  }
+  tiers.warm = snapshotPack(*di);
+  if (fresh && detail >= 1.0f) // reduced pages aren't worth keeping on disk
+    snapshotSave(idx, tiers.warm);
+  // Tall pages are only whole until packed; their tiles come from the pack
+  if (!tiers.warm.empty() && pageTiled(di->w, di->h)) {
+    if (DecodedImage *tiled = tilePage(*di)) {
+      delete di;
+      di = tiled;
+    }
+  }
+  memoryRelease(transient);
+  return di;
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// HTML parser – pull image URLs out of MangaKatana JS arrays
-// ─────────────────────────────────────────────────────────────────────────────
-std::vector<std::string> chapterImages;
-
-bool extractMangaKatanaImages(const std::string &html) {
-  chapterImages.clear();
-  std::regex arrayRx(R"(var\s+[a-zA-Z_]\w*\s*=\s*\[(.*?)\];)");
-  std::smatch m;
-  auto it = html.cbegin();
-  while (std::regex_search(it, html.cend(), m, arrayRx)) {
-    std::string arr = m[1];
-    if (arr.find("imgs") != std::string::npos) {
-      std::regex urlRx(R"('(https?://[^']+)')");
-      std::smatch um;
-      auto ui = arr.cbegin();
-      while (std::regex_search(ui, arr.cend(), um, urlRx)) {
-        if (um[1].str().find("mangakatana.com/imgs") != std::string::npos)
-          chapterImages.push_back(um[1]);
-        ui = um.suffix().first;
+static const int EVICT_MARGIN = 1; // extra pages tolerated before freeing
+
+static bool inHotRange(const MemoryBudget &b, int dist) {
+  return dist >= -b.prefetchBehind - EVICT_MARGIN &&
+         dist <= b.prefetchAhead + EVICT_MARGIN;
+}
+
+static const int TILE_MARGIN = SCREEN_W / 2; // strip pixels either side
+static const int MAX_DONE_TILES = 64;
+
+// A tile decoded by the worker, waiting for the main thread to install it.
+// `pixels` is nullptr if the page's warm tier couldn't be unpacked.
+struct DoneTile {
+  int idx, tile;
+  int w; // page width it was decoded at, in case the page was reloaded
+  uint8_t *pixels;
+};
+
+struct PageCache {
+  std::vector<DecodedImage *> pages;   // hot tier
+  std::vector<PageTiers> tiers;        // warm and cold tiers
+  std::vector<DecodedImage *> evicted; // reserved up front, main thread only
+  std::vector<bool> failed; // download or decode failed, don't retry
+  std::vector<bool> saved;  // page on disk from an earlier session
+  int current = 0;
+  MemoryBudget budget = memoryBudget();
+  bool netReady = false; // sockets and curl are up
+  int viewPage = -1;     // continuous mode viewport: page and strip offset
+  int viewOffset = 0;    // into it; -1 in page mode, where no tiles are kept
+  int tiling = -1;       // page the worker is decoding a tile of
+  std::vector<DoneTile> doneTiles;
+  bool quit = false;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::thread worker;
+};
+
+DecodedImage *cacheGet(PageCache &cache, int idx) {
+  if (idx < 0 || idx >= (int)cache.pages.size())
+    return nullptr;
+  std::lock_guard<std::mutex> lock(cache.mtx);
+  return cache.pages[idx];
+}
+
+// Whether the worker can load `idx` now. Caller holds mtx.
+static bool cacheLoadable(PageCache &cache, int idx) {
+  const PageTiers &t = cache.tiers[idx];
+  return !cache.pages[idx] && !cache.failed[idx] &&
+         (cache.netReady || cache.saved[idx] || !t.warm.empty() ||
+          !t.cold.empty());
+}
+
+// Next page the worker should load: current first, then alternating ahead
+// and behind. Returns -1 when the whole window is loaded. Caller holds mtx.
+static int cacheNextWanted(PageCache &cache) {
+  int n = (int)cache.pages.size();
+  for (int d = 0; d <= cache.budget.prefetchAhead; d++) {
+    int ahead = cache.current + d;
+    if (ahead < n && cacheLoadable(cache, ahead))
+      return ahead;
+    int behind = cache.current - d;
+    if (d > 0 && d <= cache.budget.prefetchBehind && behind >= 0 &&
+        cacheLoadable(cache, behind))
+      return behind;
+  }
+  return -1;
+}
+
+// Put a page's tiers back, minus any it has moved out of range for. Caller
+// holds mtx.
+static void cacheKeepTiers(PageCache &cache, int idx, PageTiers &&tiers) {
+  int dist = std::abs(idx - cache.current);
+  PageTiers &t = cache.tiers[idx];
+  if (dist <= cache.budget.warmRange && t.warm.empty())
+    t.warm = std::move(tiers.warm);
+  if (dist <= cache.budget.coldRange && t.cold.empty())
+    t.cold = std::move(tiers.cold);
+}
+
+// Tiles [t0, t1) of page `idx` within `margin` strip pixels of the viewport;
+// none in page mode or unless the page is hot and tiled. Unloaded pages in
+// between are taken to be a screen long. Caller holds mtx.
+static void cacheTileWindow(PageCache &cache, int idx, int margin, int &t0,
+                            int &t1) {
+  t0 = t1 = 0;
+  const DecodedImage *img = cache.pages[idx];
+  if (cache.viewPage < 0 || !img || !isTiled(*img))
+    return;
+  auto length = [&](int i) {
+    return cache.pages[i] ? stripLength(*cache.pages[i]) : SCREEN_W;
+  };
+  int top = -cache.viewOffset; // strip position of the page's first row
+  for (int i = cache.viewPage; i < idx; i++)
+    top += length(i);
+  for (int i = idx; i < cache.viewPage; i++)
+    top -= length(i);
+  int len = stripLength(*img);
+  int p0 = std::max(-margin - top, 0);
+  int p1 = std::min(SCREEN_W + margin - top, len);
+  if (p0 >= p1)
+    return;
+  t0 = (int)((int64_t)p0 * img->h / len) / TILE_ROWS;
+  t1 = std::min((int)(((int64_t)p1 * img->h + len - 1) / len + TILE_ROWS - 1) /
+                    TILE_ROWS,
+                (int)img->tiles.size());
+}
+
+// Next tile the worker should decode: those on screen first, then those
+// within TILE_MARGIN of it. Caller holds mtx.
+static bool cacheNextTile(PageCache &cache, int &idx, int &tile) {
+  if (cache.viewPage < 0 || (int)cache.doneTiles.size() >= MAX_DONE_TILES)
+    return false;
+  int first = std::max(cache.viewPage - 1, 0);
+  int last = std::min(cache.viewPage + cache.budget.prefetchAhead,
+                      (int)cache.pages.size() - 1);
+  for (int margin : {0, TILE_MARGIN})
+    for (idx = first; idx <= last; idx++) {
+      if (cache.tiers[idx].warm.empty())
+        continue;
+      int t0, t1;
+      cacheTileWindow(cache, idx, margin, t0, t1);
+      for (tile = t0; tile < t1; tile++) {
+        if (cache.pages[idx]->tiles[tile])
+          continue;
+        bool pending = false;
+        for (const DoneTile &d : cache.doneTiles)
+          pending |= d.idx == idx && d.tile == tile;
+        if (!pending)
+          return true;
       }
-      if (!chapterImages.empty())
-        return true;
     }
-    it = m.suffix().first;
-  }
   return false;
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Download image into RAM
-// ─────────────────────────────────────────────────────────────────────────────
-static const char *UA =
-    "Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
-    "AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
-
-MemoryBuffer downloadRaw(CURL *curl, const std::string &url) {
-  MemoryBuffer buf;
-  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallbackBin);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buf);
-  curl_easy_setopt(curl, CURLOPT_USERAGENT, UA);
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
-  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-  curl_easy_perform(curl);
-  return buf;
+// Decode one tile of a hot tall page from its warm tier, which cacheDemote
+// leaves alone meanwhile. Called with the lock held, drops it while working.
+static void cacheDecodeTile(PageCache &cache,
+                            std::unique_lock<std::mutex> &lock, int idx,
+                            int tile) {
+  const DecodedImage *img = cache.pages[idx];
+  int w = img->w, row0 = tile * TILE_ROWS;
+  int rows = std::min(TILE_ROWS, img->h - row0);
+  const std::vector<uint8_t> &packed = cache.tiers[idx].warm;
+  cache.tiling = idx;
+  lock.unlock();
+  auto *pixels = (uint8_t *)pixelAlloc((size_t)w * rows * 4);
+  if (pixels && !snapshotUnpackRows(packed, row0, rows, pixels)) {
+    pixelFree(pixels);
+    pixels = nullptr;
+  }
+  lock.lock();
+  cache.tiling = -1;
+  if (!pixels) // reload the page from its cold tier instead
+    std::vector<uint8_t>().swap(cache.tiers[idx].warm);
+  cache.doneTiles.push_back({idx, tile, w, pixels});
 }
 
-// ─────────────────────────────────────────────────────────────────────────────
-// Blit RGBA pixels to the native libnx framebuffer in portrait mode.
-// The Switch framebuffer is RGBA8 linear at 1280×720.
-// We rotate the image 90° clockwise so a tall manga strip fills the screen
-// when the user holds the Switch sideways (Tate/Portrait mode).
-// ─────────────────────────────────────────────────────────────────────────────
-struct DecodedImage {
-  uint8_t *pixels = nullptr;
-  int w = 0, h = 0;
-  ~DecodedImage() {
-    if (pixels)
-      stbi_image_free(pixels);
+static void cacheWorker(PageCache *cache) {
+  CURL *curl = nullptr; // created once the network is up
+  std::unique_lock<std::mutex> lock(cache->mtx);
+  while (!cache->quit) {
+    // Tiles are a few milliseconds each and may be on screen already, so
+    // they go before loading more pages
+    int tileIdx, tile;
+    if (cacheNextTile(*cache, tileIdx, tile)) {
+      cacheDecodeTile(*cache, lock, tileIdx, tile);
+      continue;
+    }
+    int idx = cacheNextWanted(*cache);
+    if (idx < 0) {
+      cache->cv.wait(lock);
+      continue;
+    }
+    // The tiers are the worker's while it loads; the main thread only ever
+    // sees them empty in the meantime.
+    bool saved = cache->saved[idx], netReady = cache->netReady;
+    float detail = cache->budget.detail;
+    PageTiers tiers = std::move(cache->tiers[idx]);
+    cache->tiers[idx] = PageTiers();
+    lock.unlock();
+    if (netReady && !curl)
+      curl = curl_easy_init();
+    DecodedImage *di =
+        loadPage(netReady ? curl : nullptr, idx, tiers, saved, detail);
+    lock.lock();
+
+    // The reader may have moved on while we were loading.
+    cacheKeepTiers(*cache, idx, std::move(tiers));
+    if (!di && !netReady)
+      cache->saved[idx] = false; // unreadable file: wait for the network
+    else if (!di)
+      cache->failed[idx] = true;
+    else if (cache->pages[idx] ||
+             !inHotRange(cache->budget, idx - cache->current))
+      delete di;
+    else
+      cache->pages[idx] = di;
   }
-};
+  lock.unlock();
+  if (curl)
+    curl_easy_cleanup(curl);
+}
 
-void blitPortrait(u32 *fb, const DecodedImage &img, int scrollY) {
-  // Scale so the original image height maps to SCREEN_W (720px)
-  // (we rotate 90°, so the image height becomes the display width)
-  float scaleY = (float)SCREEN_W / img.h; // fits height → screen width
-  float scaleX = scaleY;                  // keep aspect ratio
-  int dstH = (int)(img.w * scaleX);       // how tall on screen after rotation
-
-  for (int sy = 0; sy < SCREEN_H; sy++) {
-    // Map screen column (sy) back through the 90° rotation
-    // rotated y on screen ↔ original x axis
-    int origX = (int)((sy - scrollY) / scaleX);
-    if (origX < 0 || origX >= img.w)
-      continue;
+void cacheSetNetReady(PageCache &cache) {
+  {
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    cache.netReady = true;
+  }
+  cache.cv.notify_one();
+}
 
-    for (int sx = 0; sx < SCREEN_W; sx++) {
-      // rotated x on screen ↔ original y axis (reversed)
-      int origY = img.h - 1 - (int)(sx / scaleY);
-      if (origY < 0 || origY >= img.h)
-        continue;
+void cacheStart(PageCache &cache) {
+  cache.evicted.reserve(cache.pages.size());
+  cache.doneTiles.reserve(MAX_DONE_TILES);
+  cache.worker = std::thread(cacheWorker, &cache);
+}
 
-      uint8_t *p = img.pixels + (origY * img.w + origX) * 4;
-      u32 colour = RGBA8(p[0], p[1], p[2], 0xFF);
-      fb[sy * SCREEN_W + sx] = colour;
+// Demote pages that are too far from the current one for the budget:
+// decoded pixels are dropped first, then the packed and finally the encoded
+// copies as the distance grows. Caller holds mtx; decoded pages are only
+// collected in `evicted` for cacheFreeEvicted. The warm tier of a tall page
+// is its tiles' source, so it stays while the page is hot or being tiled.
+static void cacheDemote(PageCache &cache) {
+  const MemoryBudget &b = cache.budget;
+  for (int i = 0; i < (int)cache.pages.size(); i++) {
+    int dist = i - cache.current;
+    if (cache.pages[i] && !inHotRange(b, dist)) {
+      cache.evicted.push_back(cache.pages[i]);
+      cache.pages[i] = nullptr;
     }
+    PageTiers &t = cache.tiers[i];
+    bool tileSource = i == cache.tiling ||
+                      (cache.pages[i] && isTiled(*cache.pages[i]));
+    if (std::abs(dist) > b.warmRange && !t.warm.empty() && !tileSource)
+      std::vector<uint8_t>().swap(t.warm);
+    if (std::abs(dist) > b.coldRange && !t.cold.empty())
+      std::vector<uint8_t>().swap(t.cold);
+  }
+}
+
+static void cacheFreeEvicted(PageCache &cache) {
+  cache.cv.notify_one();
+  for (auto *p : cache.evicted)
+    delete p;
+  cache.evicted.clear();
+}
+
+// Move the prefetch window.
+void cacheSetCurrent(PageCache &cache, int current) {
+  {
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    if (cache.current == current)
+      return;
+    cache.current = current;
+    cacheDemote(cache);
+  }
+  cacheFreeEvicted(cache);
+}
+
+// Apply a new memory budget; pages already loaded are demoted right away if
+// the budget shrank.
+void cacheSetBudget(PageCache &cache, const MemoryBudget &budget) {
+  {
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    cache.budget = budget;
+    cacheDemote(cache);
+  }
+  cacheFreeEvicted(cache);
+}
+
+// Tell the cache where the continuous mode viewport is (page -1 in page
+// mode), install the tiles the worker has decoded and free the tiles that
+// are now more than a tile beyond TILE_MARGIN of the viewport. Tiles are
+// freed right here: a pool free is a few instructions.
+void cacheSetView(PageCache &cache, int page, int offset) {
+  bool moved, added;
+  {
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    moved = page != cache.viewPage || offset != cache.viewOffset;
+    added = !cache.doneTiles.empty();
+    cache.viewPage = page;
+    cache.viewOffset = offset;
+    for (const DoneTile &d : cache.doneTiles) {
+      DecodedImage *img = cache.pages[d.idx];
+      if (!d.pixels && img) {
+        cache.evicted.push_back(img);
+        cache.pages[d.idx] = nullptr;
+      } else if (img && isTiled(*img) && img->w == d.w &&
+                 !img->tiles[d.tile]) {
+        img->tiles[d.tile] = d.pixels;
+        img->tileVersion++;
+      } else {
+        pixelFree(d.pixels);
+      }
+    }
+    cache.doneTiles.clear();
+
+    if (moved || added) {
+      const MemoryBudget &b = cache.budget;
+      int first = std::max(cache.current - b.prefetchBehind - EVICT_MARGIN, 0);
+      int last = std::min(cache.current + b.prefetchAhead + EVICT_MARGIN,
+                          (int)cache.pages.size() - 1);
+      for (int i = first; i <= last; i++) {
+        DecodedImage *img = cache.pages[i];
+        if (!img || !isTiled(*img))
+          continue;
+        int t0, t1;
+        cacheTileWindow(cache, i, TILE_MARGIN, t0, t1);
+        for (int t = 0; t < (int)img->tiles.size(); t++)
+          if (img->tiles[t] && (t < t0 - 1 || t > t1)) {
+            pixelFree(img->tiles[t]);
+            img->tiles[t] = nullptr;
+          }
+      }
+    }
+  }
+  // Wake the worker for the tiles the new position wants
+  if (moved || added)
+    cacheFreeEvicted(cache);
+}
+
+void cacheStop(PageCache &cache) {
+  {
+    std::lock_guard<std::mutex> lock(cache.mtx);
+    cache.quit = true;
   }
+  cache.cv.notify_one();
+  if (cache.worker.joinable())
+    cache.worker.join();
+  for (const DoneTile &d : cache.doneTiles)
+    pixelFree(d.pixels);
+  cache.doneTiles.clear();
+  for (auto *p : cache.pages)
+    delete p;
+  cache.pages.clear();
+  cache.tiers.clear();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Minimal console helper – print without a full console init so we can display
-// progress before the framebuffer takes over.
+// Status screen – a title bar and a message drawn straight into the
+// framebuffer, one line per '\n', with an optional progress bar (0–1) whose
+// filled part shimmers so a slow step still looks alive. Messages are also
+// echoed to stdout for the host build.
 // ─────────────────────────────────────────────────────────────────────────────
-PrintConsole statusConsole;
+void showStatus(const char *msg, float progress = -1.0f) {
+  static char lastEcho[256];
+  if (strcmp(msg, lastEcho) != 0) {
+    snprintf(lastEcho, sizeof(lastEcho), "%s", msg);
+    printf("%s\n", msg);
+    fflush(stdout);
+  }
+
+  uint32_t *fb = platformFrameBegin();
+  fillRect(fb, FULL_SCREEN, BACKGROUND);
+  int line = textLineHeight();
+  fillRect(fb, portraitRect(0, 0, PORTRAIT_W, line + 16),
+           rgba8(0, 170, 170, 255));
+  textDraw(fb, 12, 8, "KatanaReaderNX", rgba8(0, 0, 0, 255));
+
+  int v = line * 2 + 16;
+  char text[256];
+  snprintf(text, sizeof(text), "%s", msg);
+  for (char *s = text, *end; s; s = end ? end + 1 : nullptr, v += line) {
+    end = strchr(s, '\n');
+    if (end)
+      *end = '\0';
+    textDraw(fb, 12, v, s, rgba8(255, 255, 255, 255));
+  }
 
-void showStatus(const char *msg) {
-  consoleClear();
-  printf("\x1b[1;1H\x1b[46;30m KatanaReaderNX \x1b[0m\n\n");
-  printf("%s\n", msg);
-  consoleUpdate(NULL);
+  if (progress >= 0.0f) {
+    const int u0 = 12, u1 = PORTRAIT_W - 12, barH = 10;
+    int filled = u0 + (int)((u1 - u0) * std::min(progress, 1.0f));
+    v += line / 2;
+    fillRect(fb, portraitRect(u0, v, u1, v + barH), rgba8(40, 40, 60, 255));
+    fillRect(fb, portraitRect(u0, v, filled, v + barH),
+             rgba8(0, 170, 170, 255));
+    int shimmer = u0 + (int)(platformNowNs() / 4000000 % (u1 - u0));
+    if (shimmer < filled)
+      fillRect(fb, portraitRect(shimmer, v, std::min(shimmer + 40, filled),
+                                v + barH),
+               rgba8(120, 230, 230, 255));
+  }
+  platformFrameEnd();
 }
 
 // ─────────────────────────────────────────────────────────────────────────────
-// Main
+// Start-up worker
+// Sockets, curl, the chapter HTML, parsing and the first page are one chain
+// of dependent network steps; they run on their own thread while the main
+// thread brings up the framebuffer and text and then animates the progress
+// screen. The main loop is not entered (and no input is consumed) until the
+// chain is done, so recorded sessions replay the same way.
 // ─────────────────────────────────────────────────────────────────────────────
-int main(int argc, char *argv[]) {
-  // libnx basics
-  consoleInit(&statusConsole);
-  padConfigureInput(1, HidNpadStyleSet_NpadStandard);
-  PadState pad;
-  padInitializeDefault(&pad);
-  socketInitializeDefault();
-  curl_global_init(CURL_GLOBAL_DEFAULT);
+static const char *const STARTUP_STEPS[] = {
+    "Starting network...",
+    "Connecting to MangaKatana...",
+    "Parsing image list...",
+    "Downloading page 1...",
+};
+static const int STARTUP_STEP_COUNT = 4;
+
+struct StartupJob {
+  std::mutex mtx;
+  std::condition_variable cv;
+  int step = 0; // index into STARTUP_STEPS, guarded by mtx
+  bool done = false;
+  bool resuming = false; // page list known already: only bring up the net
+  bool parsed = false;
+  DecodedImage *firstPage = nullptr;
+  PageTiers firstTiers;
+  PageCache *cache = nullptr; // told once the network is up
+  std::thread thread;
+};
 
-  showStatus("Connecting to MangaKatana...");
+static void startupSetStep(StartupJob &job, int step) {
+  {
+    std::lock_guard<std::mutex> lock(job.mtx);
+    job.step = step;
+  }
+  job.cv.notify_one();
+}
+
+static void startupWorker(StartupJob *job) {
+  platformNetInit();
+  startupMark("netInit");
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+  startupMark("curlInit");
+  if (job->resuming) {
+    cacheSetNetReady(*job->cache);
+    std::lock_guard<std::mutex> lock(job->mtx);
+    job->done = true;
+    return;
+  }
 
-  // ── Step 1: Fetch chapter HTML ─────────────────────────────────────────
+  startupSetStep(*job, 1);
   CURL *curl = curl_easy_init();
   std::string html;
-  curl_easy_setopt(curl, CURLOPT_URL,
-                   "https://mangakatana.com/manga/solo-leveling.16520/c200");
-  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallbackStr);
-  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &html);
-  curl_easy_setopt(curl, CURLOPT_USERAGENT, UA);
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
-  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-  curl_easy_perform(curl);
-
-  showStatus("Parsing image list...");
-
-  if (!extractMangaKatanaImages(html) || chapterImages.empty()) {
-    showStatus("[ERROR] Could not parse chapter images. Press [+] to exit.");
-    while (appletMainLoop()) {
-      padUpdate(&pad);
-      if (padGetButtonsDown(&pad) & HidNpadButton_Plus)
-        break;
-      consoleUpdate(NULL);
-    }
-    curl_easy_cleanup(curl);
+  {
+    TRACE_SCOPE("fetchChapterHtml");
+    ALLOC_STAGE("download");
+    MemoryBuffer raw = downloadRaw(curl, chapterUrl());
+    html.assign(raw.data.begin(), raw.data.end());
+  }
+  startupMark("fetchChapterHtml");
+
+  startupSetStep(*job, 2);
+  {
+    TRACE_SCOPE("extractMangaKatanaImages");
+    ALLOC_STAGE("parse");
+    job->parsed = extractMangaKatanaImages(html) && !chapterImages.empty();
+  }
+  startupMark("parse");
+
+  if (job->parsed) {
+    startupSetStep(*job, 3);
+    job->firstPage =
+        loadPage(curl, 0, job->firstTiers, false, memoryBudget().detail);
+    startupMark("firstPageLoad");
+  }
+  curl_easy_cleanup(curl);
+
+  {
+    std::lock_guard<std::mutex> lock(job->mtx);
+    job->done = true;
+  }
+  job->cv.notify_one();
+}
+
+// Animate the progress screen until the worker is done; redraws on every
+// step change and a few times a second in between.
+static void startupWait(StartupJob &job) {
+  std::unique_lock<std::mutex> lock(job.mtx);
+  int shown = -1;
+  while (!job.done) {
+    int step = job.step;
+    lock.unlock();
+    showStatus(STARTUP_STEPS[step], (step + 0.5f) / STARTUP_STEP_COUNT);
+    shown = step;
+    lock.lock();
+    job.cv.wait_for(lock, std::chrono::milliseconds(50),
+                    [&] { return job.done || job.step != shown; });
+  }
+  lock.unlock();
+  job.thread.join();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Main
+// ─────────────────────────────────────────────────────────────────────────────
+int main(int argc, char *argv[]) {
+  startupBegin();
+
+  // ── Step 1: Start-up ───────────────────────────────────────────────────
+  // Input comes up first, then the network chain starts in the background
+  // while the framebuffer and text atlas are created here; everything from
+  // then on is drawn in-frame, status screens included.
+  platformInit(argc, argv);
+  startupMark("platformInit");
+  memoryInit();
+  pixelPoolInit(memoryBudget().poolBytes);
+  writerSetLowMemory(memoryLevel() >= MEMORY_TIGHT);
+  writerStart();
+
+  // Reopening the chapter read last time needs no network to get going: the
+  // page list and position come from the resume state and the page itself
+  // from disk.
+  ResumeState resume;
+  bool resuming = resumeLoad(resume) && resume.chapter == chapterUrl() &&
+                  !resume.images.empty();
+  if (!resuming) {
+    resumePrunePages(1, 0);
+    snapshotPrune(1, 0);
+  }
+
+  PageCache cache;
+  StartupJob job;
+  job.resuming = resuming;
+  job.cache = &cache;
+  job.thread = std::thread(startupWorker, &job);
+
+  if (!platformFramebufferInit()) {
+    // Nothing can be drawn, so there is no status screen to show this on
+    printf("[ERROR] Could not create the framebuffer.\n");
+    job.thread.join();
+    delete job.firstPage;
     curl_global_cleanup();
-    socketExit();
-    consoleExit(NULL);
+    writerStop();
+    sessionFinish();
+    platformExit();
     return 1;
   }
+  startupMark("framebufferInit");
+  textInit();
+  startupMark("textInit");
 
-  printf("Found %zu pages!\n", chapterImages.size());
-  consoleUpdate(NULL);
-
-  // ── Step 2: Download & decode one page at a time ───────────────────────
-  // We keep at most 3 decoded images in RAM to avoid OOM.
-  // For the initial test, load the first page only.
-  std::vector<DecodedImage *> pages(chapterImages.size(), nullptr);
   int current = 0;
+  if (resuming) {
+    chapterImages = resume.images;
+    current = std::min(std::max(resume.page, 0), (int)chapterImages.size() - 1);
+    job.firstPage = loadPage(nullptr, current, job.firstTiers, true,
+                             memoryBudget().detail);
+    job.parsed = true;
+    startupMark("resumePageLoad");
+  } else {
+    startupWait(job);
+  }
 
-  auto loadPage = [&](int idx) {
-    if (idx < 0 || idx >= (int)pages.size())
-      return;
-    if (pages[idx])
-      return; // already loaded
-    char buf[64];
-    snprintf(buf, sizeof(buf), "Downloading page %d / %zu...", idx + 1,
-             pages.size());
-    showStatus(buf);
-
-    MemoryBuffer raw = downloadRaw(curl, chapterImages[idx]);
-    if (raw.data.empty())
-      return;
-
-    auto *di = new DecodedImage();
-    int channels;
-    di->pixels = stbi_load_from_memory(raw.data.data(), (int)raw.data.size(),
-                                       &di->w, &di->h, &channels, 4);
-    if (!di->pixels) {
-      delete di;
-      return;
+  if (!job.parsed) {
+    showStatus("[ERROR] Could not parse chapter images.\nPress [+] to exit.");
+    while (platformMainLoop()) {
+      uint64_t kDown, kHeld;
+      platformPollInput(kDown, kHeld);
+      sessionInput(kHeld);
+      if (kDown & BUTTON_PLUS)
+        break;
+      platformWaitVsync();
     }
-    pages[idx] = di;
-  };
+    curl_global_cleanup();
+    textExit();
+    platformFramebufferExit();
+    writerStop();
+    sessionFinish();
+    startupReport();
+    pixelPoolReport();
+    decoderReport();
+    platformExit();
+    return 1;
+  }
 
-  // Pre-load first page
-  loadPage(0);
-  curl_easy_cleanup(curl);
+  // ── Step 2: Download & decode pages around the reading position ────────
+  // The first page came from the start-up worker (or from disk when
+  // resuming); everything after that is loaded by the cache worker in the
+  // background.
+  cache.pages.assign(chapterImages.size(), nullptr);
+  cache.tiers.resize(chapterImages.size());
+  cache.failed.assign(chapterImages.size(), false);
+  cache.saved.assign(chapterImages.size(), false);
+  for (int i = 0; i < (int)chapterImages.size(); i++)
+    cache.saved[i] = resuming && (snapshotHas(i) || resumeHasPage(i));
+  cache.current = current;
+  if (!resuming)
+    cache.netReady = true;
+
+  cache.pages[current] = job.firstPage;
+  cache.tiers[current] = std::move(job.firstTiers);
+  cacheStart(cache);
 
   // ── Step 3: Framebuffer rendering loop ────────────────────────────────
-  consoleExit(NULL); // done with text console, switch to raw framebuffer
-
-  Framebuffer fb;
-  framebufferCreate(&fb, nwindowGetDefault(), SCREEN_W, SCREEN_H,
-                    PIXEL_FORMAT_RGBA_8888, 2);
-  framebufferMakeLinear(&fb);
+  renderSetThreads(MAX_RENDER_THREADS);
+  hudInit();
 
+  const int lastPage = (int)cache.pages.size() - 1;
   int scrollY = 0;
   int scrollStep = 20;
   bool running = true;
 
-  while (running && appletMainLoop()) {
-    padUpdate(&pad);
-    u64 kDown = padGetButtonsDown(&pad);
-    u64 kHeld = padGetButtons(&pad);
+  // Continuous mode reads the chapter as one strip. The position is kept as
+  // an offset into the current page so that pages changing length when they
+  // finish loading never make the view jump.
+  bool continuous = true;
+  int pageOffset = 0;
+  if (resuming) {
+    continuous = resume.continuous;
+    if (continuous)
+      pageOffset = resume.offset;
+    else
+      scrollY = resume.offset;
+  }
+  int estimatedLen = SCREEN_W; // strip length assumed for unloaded pages
+
+  FrameState prevFrame, frame;
+  Rect overlay = {0, 0, 0, 0}; // HUD area drawn over the previous frame
+  int visited = -1;            // last page counted for the cache hit rate
+
+  // Tiles are only ever added or freed by this thread, in cacheSetView
+  auto visiblePage = [&](int idx, int pos) {
+    DecodedImage *img = cacheGet(cache, idx);
+    return VisiblePage{idx, img, pos, img ? img->tileVersion : 0};
+  };
+
+  auto pageLength = [&](int idx) {
+    DecodedImage *img = cacheGet(cache, idx);
+    if (!img)
+      return estimatedLen;
+    estimatedLen = stripLength(*img);
+    return estimatedLen;
+  };
 
-    if (kDown & HidNpadButton_Plus)
+  while (running && platformMainLoop()) {
+    ALLOC_FRAME();
+    ALLOC_STAGE("frame");
+    uint64_t kDown, kHeld;
+    platformPollInput(kDown, kHeld);
+    sessionInput(kHeld);
+
+    if (kDown & BUTTON_PLUS)
       running = false;
 
+    // Toggle between page-at-a-time and continuous strip reading
+    if (kDown & BUTTON_MINUS) {
+      continuous = !continuous;
+      scrollY = 0;
+      pageOffset = 0;
+    }
+
+    // Performance HUD: ZL+ZR
+    if ((kHeld & BUTTON_ZL) && (kHeld & BUTTON_ZR) &&
+        (kDown & (BUTTON_ZL | BUTTON_ZR)))
+      hudToggle();
+
     // Page navigation
-    if (kDown & HidNpadButton_R) {
-      current = std::min(current + 1, (int)pages.size() - 1);
+    if (kDown & BUTTON_R) {
+      current = std::min(current + 1, lastPage);
       scrollY = 0;
-      loadPage(current);
+      pageOffset = 0;
     }
-    if (kDown & HidNpadButton_L) {
+    if (kDown & BUTTON_L) {
       current = std::max(current - 1, 0);
       scrollY = 0;
+      pageOffset = 0;
     }
 
     // Scroll
-    if (kHeld & HidNpadButton_Down)
-      scrollY -= scrollStep;
-    if (kHeld & HidNpadButton_Up)
-      scrollY += scrollStep;
-    if (scrollY > 0)
-      scrollY = 0;
+    if (continuous) {
+      if (kHeld & BUTTON_DOWN)
+        pageOffset += scrollStep;
+      if (kHeld & BUTTON_UP)
+        pageOffset -= scrollStep;
+      while (pageOffset >= pageLength(current) && current < lastPage) {
+        pageOffset -= pageLength(current);
+        current++;
+      }
+      while (pageOffset < 0 && current > 0) {
+        current--;
+        pageOffset += pageLength(current);
+      }
+      pageOffset = std::max(pageOffset, 0);
+    } else {
+      if (kHeld & BUTTON_DOWN)
+        scrollY -= scrollStep;
+      if (kHeld & BUTTON_UP)
+        scrollY += scrollStep;
+      if (scrollY > 0)
+        scrollY = 0;
+    }
+    cacheSetCurrent(cache, current);
+    cacheSetView(cache, continuous ? current : -1, pageOffset);
+    if (memoryUpdate()) {
+      cacheSetBudget(cache, memoryBudget());
+      writerSetLowMemory(memoryLevel() >= MEMORY_TIGHT);
+    }
+    if (current != visited) {
+      statsPageVisit(cacheGet(cache, current) != nullptr);
+      visited = current;
+    }
 
-    // Draw
-    u32 stride;
-    u32 *framebuf = (u32 *)framebufferBegin(&fb, &stride);
+    // Lay out what this frame shows
+    frame.continuous = continuous;
+    frame.count = 0;
+    if (continuous) {
+      // Walk forward from the current page until the viewport is covered
+      int top = -pageOffset;
+      for (int idx = current;
+           idx <= lastPage && top < SCREEN_W && frame.count < MAX_VISIBLE;
+           idx++) {
+        frame.vis[frame.count++] = visiblePage(idx, top);
+        top += pageLength(idx);
+      }
+    } else {
+      frame.vis[0] = visiblePage(current, scrollY);
+      frame.count = 1;
+    }
 
-    // Clear to dark background
-    for (int i = 0; i < SCREEN_W * SCREEN_H; i++)
-      framebuf[i] = RGBA8(15, 15, 25, 255);
+    // Damage tracking: only produce a frame when scroll, page, load state,
+    // mode or the HUD text changed since the last one.
+    uint64_t frameStart = platformNowNs();
+    bool hudDirty = hudUpdate(frameStart);
+    if (!hudDirty && frameUnchanged(prevFrame, frame)) {
+      platformWaitVsync();
+      continue;
+    }
 
-    if (pages[current]) {
-      blitPortrait(framebuf, *pages[current], scrollY);
+    // Draw
+    uint32_t *framebuf = platformFrameBegin();
+
+    int dx, dy;
+    if (frameShift(prevFrame, frame, dx, dy)) {
+      shiftFrame(framebuf, prevFrame.buf, dx, dy);
+      drawFrame(framebuf, frame, exposedBand(dx, dy));
+      // The old overlay was shifted along with the page; repaint where it
+      // was and where it went before drawing the new one on top.
+      if (!rectEmpty(overlay)) {
+        Rect moved = {overlay.x0 + dx, overlay.y0 + dy, overlay.x1 + dx,
+                      overlay.y1 + dy};
+        drawFrame(framebuf, frame,
+                  rectIntersect(rectUnion(overlay, moved), FULL_SCREEN));
+      }
+    } else {
+      drawFrame(framebuf, frame, FULL_SCREEN);
     }
+    overlay = hudDraw(framebuf);
+    frame.buf = framebuf;
+    prevFrame = frame;
 
-    framebufferEnd(&fb);
+    {
+      TRACE_SCOPE("framebufferEnd");
+      platformFrameEnd();
+    }
+    uint64_t frameEnd = platformNowNs();
+    statsFrame(frameEnd, frameEnd - frameStart);
+    sessionFrame(frameEnd - frameStart);
+    if (frame.count > 0 && frame.vis[0].img)
+      startupFirstPage();
   }
 
   // Cleanup
-  framebufferClose(&fb);
-  for (auto *p : pages)
-    delete p;
+  renderSetThreads(1);
+  textExit();
+  platformFramebufferExit();
+  if (job.thread.joinable())
+    job.thread.join();
+  cacheStop(cache);
   curl_global_cleanup();
-  socketExit();
-  return 0;
+
+  // Remember where we were, and keep only the saved pages around it
+  ResumeState last;
+  last.chapter = chapterUrl();
+  last.images = chapterImages;
+  last.page = current;
+  last.continuous = continuous;
+  last.offset = continuous ? pageOffset : scrollY;
+  resumeSave(last);
+  writerStop();
+  const MemoryBudget &budget = memoryBudget();
+  resumePrunePages(current - budget.prefetchBehind,
+                   current + budget.prefetchAhead);
+  snapshotPrune(current - budget.prefetchBehind,
+                current + budget.prefetchAhead);
+#ifdef KATANA_TRACE
+  std::string tracePath = std::string(platformDataDir()) + "/trace.json";
+  TRACE_DUMP(tracePath.c_str());
+#endif
+  sessionFinish();
+  bool startupOk = startupReport();
+  pixelPoolReport();
+  decoderReport();
+  bool allocOk = ALLOC_REPORT();
+  platformExit();
+  return startupOk && allocOk ? 0 : 1;
 }
@@ -0,0 +1,86 @@
+// KatanaReaderNX – adaptive memory budget
+// See memory.h.
+
+#include "memory.h"
+#include "pixelpool.h"
+#include "platform.h"
+#include <atomic>
+#include <cstdio>
+
+static const uint64_t MB = 1ull << 20;
+static const uint64_t CHECK_INTERVAL_NS = 1000000000ull;
+
+// Free memory needed for each level, and the extra needed to move back up
+// a level so the budget doesn't flap around a threshold.
+static const uint64_t LEVEL_FREE[] = {1024 * MB, 256 * MB, 96 * MB, 0};
+static const uint64_t HYSTERESIS = 32 * MB;
+
+static const MemoryBudget BUDGETS[] = {
+    {2, 6, 16, 32, 1.0f, 108 * MB}, // plenty
+    {1, 3, 8, 16, 1.0f, 108 * MB},  // normal
+    {1, 2, 4, 8, 1.0f, 48 * MB},    // tight
+    {0, 1, 2, 4, 0.5f, 24 * MB},    // critical: half-resolution pages
+};
+
+static const char *const LEVEL_NAMES[] = {"plenty", "normal", "tight",
+                                          "critical"};
+
+static MemoryLevel level = MEMORY_NORMAL;
+static uint64_t lastCheckNs = 0;
+static std::atomic<size_t> charged{0};
+static std::atomic<bool> recheck{false};
+
+// Pool slabs nobody holds are reserved but free for pages, so they count as
+// available rather than used.
+static uint64_t freeMemory() {
+  uint64_t total = platformMemoryTotal(), used = platformMemoryUsed() + charged;
+  PixelPoolStats pool = pixelPoolStats();
+  uint64_t idle = pool.reserved - pool.inUse;
+  used = used > idle ? used - idle : 0;
+  return total > used ? total - used : 0;
+}
+
+static MemoryLevel levelFor(uint64_t free, MemoryLevel from) {
+  for (int l = MEMORY_PLENTY; l < MEMORY_CRITICAL; l++) {
+    uint64_t need = LEVEL_FREE[l] + (l < from ? HYSTERESIS : 0);
+    if (free >= need)
+      return (MemoryLevel)l;
+  }
+  return MEMORY_CRITICAL;
+}
+
+void memoryInit() {
+  uint64_t free = freeMemory();
+  level = levelFor(free, MEMORY_PLENTY);
+  lastCheckNs = platformNowNs();
+  printf("[memory] %.0f MB of %.0f MB free: %s\n", free / (double)MB,
+         platformMemoryTotal() / (double)MB, LEVEL_NAMES[level]);
+}
+
+bool memoryUpdate() {
+  uint64_t now = platformNowNs();
+  if (!recheck.exchange(false) && now - lastCheckNs < CHECK_INTERVAL_NS)
+    return false;
+  lastCheckNs = now;
+  uint64_t free = freeMemory();
+  MemoryLevel next = levelFor(free, level);
+  if (next == level)
+    return false;
+  level = next;
+  printf("[memory] %.0f MB free: %s\n", free / (double)MB,
+         LEVEL_NAMES[level]);
+  return true;
+}
+
+void memoryCharge(size_t bytes) {
+  charged += bytes;
+  recheck = true;
+}
+
+void memoryRelease(size_t bytes) { charged -= bytes; }
+
+MemoryLevel memoryLevel() { return level; }
+
+const MemoryBudget &memoryBudget() { return BUDGETS[level]; }
+
+const char *memoryLevelName() { return LEVEL_NAMES[level]; }
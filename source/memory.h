@@ -0,0 +1,47 @@
+// KatanaReaderNX – adaptive memory budget
+// How much the reader can safely cache depends on how it was launched: as an
+// applet (album) it gets a few hundred MB, with full-RAM title takeover over
+// 3 GB. The headroom left in the heap (platformMemoryTotal minus what malloc
+// has handed out, platformMemoryUsed, with the pixel pool's idle slabs
+// counted as free) is checked at start-up and about once a second after
+// that, and sorted into a level; each level has a budget for the page
+// cache's prefetch window, its warm and cold tiers (main.cpp), the pixel
+// pool (pixelpool.h) and the resolution pages are decoded at. At the
+// critical level new pages are kept at half resolution, so running low costs
+// sharpness instead of crashing.
+
+#pragma once
+#include <cstddef>
+
+enum MemoryLevel {
+  MEMORY_PLENTY,   // full-RAM title takeover
+  MEMORY_NORMAL,
+  MEMORY_TIGHT,    // applet mode
+  MEMORY_CRITICAL, // close to the limit
+};
+
+struct MemoryBudget {
+  int prefetchBehind, prefetchAhead; // hot tier: pages decoded around current
+  int warmRange, coldRange;          // pages kept packed / encoded either side
+  float detail;                      // resolution for fitToScreen (render.h)
+  size_t poolBytes;                  // pixel pool reserved at start-up
+};
+
+// Query the memory available and pick the first level.
+void memoryInit();
+
+// Re-check the free memory if a second has passed since the last check, or
+// memory was charged since. Returns true when the level changed.
+bool memoryUpdate();
+
+// A buffer about to be allocated for a short while, such as a tall page
+// decoded whole before it is tiled (main.cpp): it counts as used until
+// memoryRelease, on top of whatever it already holds, and the next
+// memoryUpdate re-checks so the page cache makes room meanwhile.
+// Thread-safe.
+void memoryCharge(size_t bytes);
+void memoryRelease(size_t bytes);
+
+MemoryLevel memoryLevel();
+const MemoryBudget &memoryBudget();
+const char *memoryLevelName();
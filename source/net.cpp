@@ -0,0 +1,60 @@
+// KatanaReaderNX – libcurl helpers
+// See net.h.
+
+#include "net.h"
+#include "session.h"
+#include "trace.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// libcurl helpers
+// ─────────────────────────────────────────────────────────────────────────────
+size_t WriteCallbackStr(void *c, size_t s, size_t n, void *u) {
+  ((std::string *)u)->append((char *)c, s * n);
+  return s * n;
+}
+size_t WriteCallbackBin(void *c, size_t s, size_t n, void *u) {
+  auto *b = (MemoryBuffer *)u;
+  uint8_t *p = (uint8_t *)c;
+  b->data.insert(b->data.end(), p, p + s * n);
+  return s * n;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Download image into RAM
+// ─────────────────────────────────────────────────────────────────────────────
+const char *UA =
+    "Mozilla/5.0 (Windows NT 10.0; Win64; x64) "
+    "AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
+
+MemoryBuffer downloadRaw(CURL *curl, const std::string &url,
+                         const char *accept) {
+  TRACE_SCOPE("downloadRaw");
+  MemoryBuffer buf;
+  if (sessionReplaying()) {
+    buf.data = sessionLoadResponse(url);
+    sessionBytes(buf.data.size());
+    return buf;
+  }
+
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallbackBin);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buf);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, UA);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+  curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+  // The handle keeps its headers between transfers, so always set them
+  curl_slist *headers = nullptr;
+  if (accept)
+    headers = curl_slist_append(headers,
+                                (std::string("Accept: ") + accept).c_str());
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  if (curl_easy_perform(curl) == CURLE_OK)
+    sessionSaveResponse(url, buf.data);
+  else
+    buf.data.clear(); // error status or broken transfer: treat as failed
+  curl_slist_free_all(headers);
+  sessionBytes(buf.data.size());
+  return buf;
+}
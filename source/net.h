@@ -0,0 +1,25 @@
+// KatanaReaderNX – libcurl helpers
+// Write callbacks and a blocking download into RAM, shared by the reader and
+// the host benchmarks.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <curl/curl.h>
+#include <string>
+#include <vector>
+
+struct MemoryBuffer {
+  std::vector<uint8_t> data;
+};
+
+// CURLOPT_WRITEFUNCTION callbacks appending to a std::string / MemoryBuffer
+size_t WriteCallbackStr(void *c, size_t s, size_t n, void *u);
+size_t WriteCallbackBin(void *c, size_t s, size_t n, void *u);
+
+// Browser user agent; MangaKatana rejects curl's default one
+extern const char *UA;
+
+// `accept`, if given, is sent as the Accept header (see decoderAccept).
+MemoryBuffer downloadRaw(CURL *curl, const std::string &url,
+                         const char *accept = nullptr);
@@ -0,0 +1,153 @@
+// KatanaReaderNX – pixel buffer pool
+// See pixelpool.h.
+
+#include "pixelpool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Requests below this always go to malloc
+static const size_t SLAB_MIN_REQUEST = 256u << 10;
+
+// Large scans are scaled down by fitToScreen until they are 1280 pixels
+// tall, about 900×1280 for a typical page, so display-ready pages fit the
+// 6 MB class; the 16 MB class holds full-size decodes of large scans while they
+// are scaled down, and the 1 MB class stb_image's smaller scratch buffers and
+// the tiles of tall pages (render.h), a dozen of which are around the viewport.
+static const struct {
+  size_t size;
+  int count;
+} SLAB_CLASSES[] = {
+    {1u << 20, 16},
+    {6u << 20, 10},
+    {16u << 20, 2},
+};
+static const int CLASS_COUNT = sizeof(SLAB_CLASSES) / sizeof(SLAB_CLASSES[0]);
+
+struct SlabClass {
+  uint8_t *base = nullptr;
+  size_t size = 0;
+  int count = 0;
+  std::vector<int> free; // free slot indices, used as a stack
+};
+
+struct PixelPool {
+  std::mutex mtx;
+  bool ready = false;
+  SlabClass classes[CLASS_COUNT];
+  PixelPoolStats stats = {};
+};
+
+static PixelPool pool;
+
+void pixelPoolInit(size_t maxBytes) {
+  std::lock_guard<std::mutex> lock(pool.mtx);
+  if (pool.ready)
+    return;
+  size_t full = 0;
+  for (const auto &c : SLAB_CLASSES)
+    full += c.size * c.count;
+  double scale = std::min(1.0, (double)maxBytes / full);
+
+  for (int c = 0; c < CLASS_COUNT; c++) {
+    SlabClass &sc = pool.classes[c];
+    sc.size = SLAB_CLASSES[c].size;
+    int count = (int)(SLAB_CLASSES[c].count * scale + 0.5);
+    sc.base = count ? (uint8_t *)malloc(sc.size * count) : nullptr;
+    if (!sc.base)
+      continue; // this class simply stays empty
+    sc.count = count;
+    for (int i = sc.count - 1; i >= 0; i--)
+      sc.free.push_back(i);
+    pool.stats.reserved += sc.size * sc.count;
+  }
+  pool.ready = true;
+}
+
+// Class whose slabs contain `p`, or -1 for a malloc'd block. Caller holds mtx.
+static int classOf(const void *p) {
+  for (int c = 0; c < CLASS_COUNT; c++) {
+    const SlabClass &sc = pool.classes[c];
+    if (p >= sc.base && p < sc.base + sc.size * sc.count)
+      return c;
+  }
+  return -1;
+}
+
+void *pixelAlloc(size_t size) {
+  if (size >= SLAB_MIN_REQUEST) {
+    std::lock_guard<std::mutex> lock(pool.mtx);
+    if (pool.ready) {
+      // Smallest class that fits and still has a free slab
+      for (SlabClass &sc : pool.classes) {
+        if (sc.size < size || sc.free.empty())
+          continue;
+        int slot = sc.free.back();
+        sc.free.pop_back();
+        pool.stats.inUse += sc.size;
+        pool.stats.peakInUse = std::max(pool.stats.peakInUse, pool.stats.inUse);
+        pool.stats.slabAllocs++;
+        return sc.base + sc.size * slot;
+      }
+      pool.stats.fallbackAllocs++;
+    }
+  }
+  return malloc(size);
+}
+
+void pixelFree(void *p) {
+  if (!p)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(pool.mtx);
+    int c = classOf(p);
+    if (c >= 0) {
+      SlabClass &sc = pool.classes[c];
+      sc.free.push_back((int)(((uint8_t *)p - sc.base) / sc.size));
+      pool.stats.inUse -= sc.size;
+      return;
+    }
+  }
+  free(p);
+}
+
+void *pixelRealloc(void *p, size_t size) {
+  if (!p)
+    return pixelAlloc(size);
+  size_t slabSize = 0;
+  {
+    std::lock_guard<std::mutex> lock(pool.mtx);
+    int c = classOf(p);
+    if (c >= 0)
+      slabSize = pool.classes[c].size;
+  }
+  if (!slabSize)
+    return realloc(p, size); // malloc'd blocks stay on the heap
+  if (size <= slabSize)
+    return p;
+  void *q = pixelAlloc(size);
+  if (q) {
+    memcpy(q, p, slabSize);
+    pixelFree(p);
+  }
+  return q;
+}
+
+PixelPoolStats pixelPoolStats() {
+  std::lock_guard<std::mutex> lock(pool.mtx);
+  return pool.stats;
+}
+
+void pixelPoolReport() {
+  PixelPoolStats s = pixelPoolStats();
+  if (!s.reserved)
+    return;
+  printf("[pool] %.0f MB reserved, peak %.1f MB in use, %llu slab / %llu "
+         "fallback allocations\n",
+         s.reserved / 1048576.0, s.peakInUse / 1048576.0,
+         (unsigned long long)s.slabAllocs,
+         (unsigned long long)s.fallbackAllocs);
+}
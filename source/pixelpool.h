@@ -0,0 +1,35 @@
+// KatanaReaderNX – pixel buffer pool
+// Decoded pages are several megabytes each and come and go with every page
+// turn, which fragments the Switch's heap quickly. Instead, large buffers
+// come from a fixed set of size-classed slabs reserved once at start-up and
+// recycled between pages: page pixels, fitToScreen output, unpacked
+// snapshots and stb_image's own scratch buffers (decoder.cpp points
+// STBI_MALLOC, STBI_REALLOC and STBI_FREE here).
+//
+// Small requests, and large ones when every fitting slab is taken, fall back
+// to malloc. Before pixelPoolInit everything does. All functions are
+// thread-safe, and pixelFree/pixelRealloc accept either kind of block.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Reserve the slabs: the full set is about 110 MB, and every class is
+// scaled down in proportion when `maxBytes` is less (see memory.h).
+void pixelPoolInit(size_t maxBytes);
+
+void *pixelAlloc(size_t size);
+void *pixelRealloc(void *p, size_t size);
+void pixelFree(void *p);
+
+struct PixelPoolStats {
+  size_t reserved;  // bytes of slabs reserved at start-up
+  size_t inUse;     // bytes of slabs handed out right now
+  size_t peakInUse; // high-water mark of inUse
+  uint64_t slabAllocs;
+  uint64_t fallbackAllocs; // large requests that had to go to malloc
+};
+PixelPoolStats pixelPoolStats();
+
+// Print the stats (nothing before pixelPoolInit).
+void pixelPoolReport();
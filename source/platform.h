@@ -0,0 +1,94 @@
+// KatanaReaderNX – platform layer
+// Everything the reader needs from the system: pad input, sockets, the main
+// loop, fonts and the framebuffer. platform_switch.cpp implements it with
+// libnx; platform_host.cpp implements it for Linux with a headless in-memory
+// framebuffer and scripted input, so every hot path can be run under perf or
+// valgrind on a workstation.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Buttons – same bits as libnx HidNpadButton_*, so the Switch backend passes
+// the pad state straight through.
+// ─────────────────────────────────────────────────────────────────────────────
+enum : uint64_t {
+  BUTTON_A = 1ull << 0,
+  BUTTON_B = 1ull << 1,
+  BUTTON_X = 1ull << 2,
+  BUTTON_Y = 1ull << 3,
+  BUTTON_L = 1ull << 6,
+  BUTTON_R = 1ull << 7,
+  BUTTON_ZL = 1ull << 8,
+  BUTTON_ZR = 1ull << 9,
+  BUTTON_PLUS = 1ull << 10,
+  BUTTON_MINUS = 1ull << 11,
+  BUTTON_LEFT = 1ull << 12,
+  BUTTON_UP = 1ull << 13,
+  BUTTON_RIGHT = 1ull << 14,
+  BUTTON_DOWN = 1ull << 15,
+};
+
+// Names used by host input scripts and recorded sessions
+static const struct {
+  const char *name;
+  uint64_t bit;
+} BUTTON_NAMES[] = {
+    {"A", BUTTON_A},         {"B", BUTTON_B},         {"X", BUTTON_X},
+    {"Y", BUTTON_Y},         {"L", BUTTON_L},         {"R", BUTTON_R},
+    {"ZL", BUTTON_ZL},       {"ZR", BUTTON_ZR},       {"PLUS", BUTTON_PLUS},
+    {"MINUS", BUTTON_MINUS}, {"LEFT", BUTTON_LEFT},   {"UP", BUTTON_UP},
+    {"RIGHT", BUTTON_RIGHT}, {"DOWN", BUTTON_DOWN},
+};
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Lifecycle
+// ─────────────────────────────────────────────────────────────────────────────
+// Bring up input. The host backend also parses its command line options here
+// (see platform_host.cpp), and both backends start session recording or
+// replay here (see session.h).
+void platformInit(int argc, char *argv[]);
+void platformExit();
+
+// Bring up sockets. Slow on the Switch, so the reader calls it from its
+// start-up worker thread while the framebuffer comes up.
+void platformNetInit();
+
+// Directory for files the reader writes (traces, caches, saved state).
+// Created by platformInit; no trailing slash.
+const char *platformDataDir();
+
+// Monotonic clock in nanoseconds.
+uint64_t platformNowNs();
+
+// Heap memory currently handed out by malloc, and the most it may use, in
+// bytes. On the Switch the total is the heap libnx reserved at start-up,
+// whose size depends on how the reader was launched (applet or title
+// takeover); the host takes it from --mem-limit MB.
+uint64_t platformMemoryUsed();
+uint64_t platformMemoryTotal();
+
+// A TrueType font for in-frame text: the system shared font on the Switch,
+// --font FILE (or DejaVu Sans) on the host. nullptr if none is available.
+const uint8_t *platformFontData(size_t &size);
+
+// False once the system (or the host input script) asks the app to quit.
+bool platformMainLoop();
+
+// Sample the pad: buttons newly pressed this frame and buttons held.
+void platformPollInput(uint64_t &down, uint64_t &held);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Framebuffer – 1280×720 linear RGBA8
+// ─────────────────────────────────────────────────────────────────────────────
+bool platformFramebufferInit();
+void platformFramebufferExit();
+
+// The returned buffer is only valid until platformFrameEnd. It may be the
+// same buffer as the previous frame (libnx linear mode) or a different one.
+uint32_t *platformFrameBegin();
+void platformFrameEnd();
+
+// Block until the next vsync; used when a frame is skipped.
+void platformWaitVsync();
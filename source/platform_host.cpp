@@ -0,0 +1,252 @@
+// KatanaReaderNX – Linux host platform backend
+// Headless: the framebuffer lives in memory and input comes from a script.
+// Command line options:
+//
+//   --script FILE   input script, one "<frames> [BUTTON ...]" entry per line,
+//                   e.g. "60 DOWN" holds Down for 60 frames. Lines starting
+//                   with '#' are comments. The app quits when it runs out.
+//   --frames N      without a script, quit after N main loop iterations
+//                   (default 600)
+//   --no-vsync      don't sleep when a frame is skipped
+//   --dump FILE     write the last presented frame to FILE as a binary PPM
+//   --data-dir DIR  where traces, caches and saved state go (katana_data)
+//   --font FILE     TrueType font for in-frame text (DejaVu Sans)
+//   --record DIR    record input and HTTP responses into DIR (session.h)
+//   --replay DIR    replay a recorded session: DIR/input.txt becomes the
+//                   input script and downloads are answered from DIR/http
+//   --latency MS    replay only: delay added to every response
+//   --kbps N        replay only: bandwidth cap for responses
+//   --zero-alloc N  fail (exit 1) if any main loop iteration after the first N
+//                   allocates on the main thread (see alloc.h)
+//   --ttfp-budget MS
+//                   fail (exit 1) if the first page takes longer than MS to
+//                   appear (see startup.h)
+//   --sync-writes   write files on the thread that makes them instead of the
+//                   disk writer thread, to measure what write-behind saves
+//   --mem-limit MB  memory the reader may use, to try out the budgets in
+//                   memory.h (default: the machine's physical memory)
+//   --base-url URL  read the chapter from URL instead of mangakatana.com,
+//                   e.g. http://127.0.0.1:8080 for tools/standin_server.cpp
+
+#ifndef __SWITCH__
+#include "platform.h"
+#include "alloc.h"
+#include "chapter.h"
+#include "render.h"
+#include "session.h"
+#include "startup.h"
+#include "writer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <malloc.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct ScriptEntry {
+  int frames;
+  uint64_t buttons;
+};
+
+static std::vector<ScriptEntry> script;
+static bool haveScript = false;
+static long maxFrames = 600;
+static bool noVsync = false;
+static std::string dumpPath;
+static std::string dataDir = "katana_data";
+static std::string fontPath = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
+static std::string recordDir, replayDir;
+static int latencyMs = 0, kbps = 0;
+static uint64_t memLimit = 0;
+
+static long loopCount = 0;
+static uint64_t prevHeld = 0;
+static std::vector<uint32_t> framebuffer;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Input script
+// ─────────────────────────────────────────────────────────────────────────────
+static uint64_t buttonFromName(const char *name) {
+  for (const auto &n : BUTTON_NAMES)
+    if (strcmp(n.name, name) == 0)
+      return n.bit;
+  fprintf(stderr, "[host] unknown button '%s' in script\n", name);
+  return 0;
+}
+
+static bool loadScript(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char *tok = strtok(line, " \t\r\n");
+    if (!tok || tok[0] == '#')
+      continue;
+    ScriptEntry e = {atoi(tok), 0};
+    while ((tok = strtok(NULL, " \t\r\n")))
+      e.buttons |= buttonFromName(tok);
+    if (e.frames > 0)
+      script.push_back(e);
+  }
+  fclose(f);
+  return true;
+}
+
+// Buttons held on main loop iteration `frame`, or false past the end.
+static bool scriptButtons(long frame, uint64_t &held) {
+  for (const ScriptEntry &e : script) {
+    if (frame < e.frames) {
+      held = e.buttons;
+      return true;
+    }
+    frame -= e.frames;
+  }
+  return false;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Lifecycle
+// ─────────────────────────────────────────────────────────────────────────────
+void platformInit(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--script") && hasValue) {
+      haveScript = loadScript(argv[++i]);
+      if (!haveScript)
+        fprintf(stderr, "[host] cannot read script %s\n", argv[i]);
+    } else if (!strcmp(argv[i], "--frames") && hasValue) {
+      maxFrames = atol(argv[++i]);
+    } else if (!strcmp(argv[i], "--no-vsync")) {
+      noVsync = true;
+    } else if (!strcmp(argv[i], "--dump") && hasValue) {
+      dumpPath = argv[++i];
+    } else if (!strcmp(argv[i], "--data-dir") && hasValue) {
+      dataDir = argv[++i];
+    } else if (!strcmp(argv[i], "--font") && hasValue) {
+      fontPath = argv[++i];
+    } else if (!strcmp(argv[i], "--record") && hasValue) {
+      recordDir = argv[++i];
+    } else if (!strcmp(argv[i], "--replay") && hasValue) {
+      replayDir = argv[++i];
+    } else if (!strcmp(argv[i], "--latency") && hasValue) {
+      latencyMs = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--kbps") && hasValue) {
+      kbps = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--base-url") && hasValue) {
+      chapterBaseUrl = argv[++i];
+    } else if (!strcmp(argv[i], "--zero-alloc") && hasValue) {
+      allocCheckSteadyState(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--ttfp-budget") && hasValue) {
+      startupSetBudget(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--mem-limit") && hasValue) {
+      memLimit = strtoull(argv[++i], nullptr, 10) << 20;
+    } else if (!strcmp(argv[i], "--sync-writes")) {
+      writerSetSync(true);
+    }
+  }
+  mkdir(dataDir.c_str(), 0777);
+
+  if (!replayDir.empty()) {
+    haveScript = loadScript((replayDir + "/input.txt").c_str());
+    if (!haveScript || !sessionReplay(replayDir.c_str(), latencyMs, kbps))
+      fprintf(stderr, "[host] cannot replay session %s\n", replayDir.c_str());
+  } else if (!recordDir.empty() && !sessionRecord(recordDir.c_str())) {
+    fprintf(stderr, "[host] cannot record into %s\n", recordDir.c_str());
+  }
+}
+
+void platformExit() { fflush(stdout); }
+
+void platformNetInit() {}
+
+const char *platformDataDir() { return dataDir.c_str(); }
+
+uint64_t platformNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t platformMemoryUsed() {
+  struct mallinfo2 mi = mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+}
+
+uint64_t platformMemoryTotal() {
+  if (memLimit)
+    return memLimit;
+  return (uint64_t)sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+}
+
+const uint8_t *platformFontData(size_t &size) {
+  static std::vector<uint8_t> font;
+  static bool loaded = false;
+  if (!loaded) {
+    loaded = true;
+    if (FILE *f = fopen(fontPath.c_str(), "rb")) {
+      fseek(f, 0, SEEK_END);
+      font.resize(ftell(f));
+      fseek(f, 0, SEEK_SET);
+      if (fread(font.data(), 1, font.size(), f) != font.size())
+        font.clear();
+      fclose(f);
+    }
+  }
+  size = font.size();
+  return font.empty() ? nullptr : font.data();
+}
+
+bool platformMainLoop() {
+  long frame = loopCount++;
+  if (haveScript) {
+    uint64_t held;
+    return scriptButtons(frame, held);
+  }
+  return frame < maxFrames;
+}
+
+void platformPollInput(uint64_t &down, uint64_t &held) {
+  held = 0;
+  if (haveScript)
+    scriptButtons(loopCount - 1, held);
+  down = held & ~prevHeld;
+  prevHeld = held;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Framebuffer
+// ─────────────────────────────────────────────────────────────────────────────
+bool platformFramebufferInit() {
+  framebuffer.assign((size_t)SCREEN_W * SCREEN_H, 0);
+  return true;
+}
+
+void platformFramebufferExit() {
+  if (!dumpPath.empty() && !framebuffer.empty()) {
+    if (FILE *f = fopen(dumpPath.c_str(), "wb")) {
+      fprintf(f, "P6\n%d %d\n255\n", SCREEN_W, SCREEN_H);
+      for (uint32_t px : framebuffer) {
+        uint8_t rgb[3] = {(uint8_t)px, (uint8_t)(px >> 8), (uint8_t)(px >> 16)};
+        fwrite(rgb, 1, 3, f);
+      }
+      fclose(f);
+    }
+  }
+  framebuffer.clear();
+  framebuffer.shrink_to_fit();
+}
+
+uint32_t *platformFrameBegin() { return framebuffer.data(); }
+
+void platformFrameEnd() {}
+
+void platformWaitVsync() {
+  if (!noVsync)
+    std::this_thread::sleep_for(std::chrono::microseconds(16667));
+}
+#endif
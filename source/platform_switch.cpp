@@ -0,0 +1,129 @@
+// KatanaReaderNX – libnx platform backend
+// See platform.h.
+
+#ifdef __SWITCH__
+#include "platform.h"
+#include "render.h"
+#include "session.h"
+#include <switch.h>
+#include <malloc.h>
+#include <string>
+#include <sys/stat.h>
+
+// Bounds of the newlib heap, set up by libnx at start-up
+extern "C" char *fake_heap_start;
+extern "C" char *fake_heap_end;
+
+static PadState pad;
+static bool plActive = false;
+static bool netActive = false;
+
+static Framebuffer fb;
+static ViDisplay display;
+static Event vsyncEvent;
+static bool haveDisplay = false;
+static bool haveVsync = false;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Lifecycle
+// ─────────────────────────────────────────────────────────────────────────────
+void platformInit(int argc, char *argv[]) {
+  mkdir("sdmc:/switch", 0777);
+  mkdir(platformDataDir(), 0777);
+  padConfigureInput(1, HidNpadStyleSet_NpadStandard);
+  padInitializeDefault(&pad);
+
+  // Creating this directory on the SD card opts in to session recording
+  std::string sessionDir = std::string(platformDataDir()) + "/session";
+  struct stat st;
+  if (stat(sessionDir.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+    sessionRecord(sessionDir.c_str());
+}
+
+void platformExit() {
+  if (plActive)
+    plExit();
+  if (netActive)
+    socketExit();
+}
+
+void platformNetInit() {
+  netActive = R_SUCCEEDED(socketInitializeDefault());
+}
+
+const char *platformDataDir() { return "sdmc:/switch/KatanaReaderNX"; }
+
+uint64_t platformNowNs() { return armTicksToNs(armGetSystemTick()); }
+
+// libnx hands all of the process's memory to the newlib heap at start-up, so
+// the kernel's used-memory figure never moves; ask malloc instead.
+uint64_t platformMemoryUsed() { return mallinfo().uordblks; }
+
+// The heap, not the process total: code, stacks and the framebuffer live
+// outside it, and malloc can never hand out more than it holds.
+uint64_t platformMemoryTotal() {
+  return (uint64_t)(fake_heap_end - fake_heap_start);
+}
+
+const uint8_t *platformFontData(size_t &size) {
+  static PlFontData font;
+  if (!plActive) {
+    if (R_FAILED(plInitialize(PlServiceType_User)))
+      return nullptr;
+    plActive = true;
+    if (R_FAILED(plGetSharedFontByType(&font, PlSharedFontType_Standard)))
+      font.address = nullptr;
+  }
+  size = font.size;
+  return (const uint8_t *)font.address;
+}
+
+bool platformMainLoop() { return appletMainLoop(); }
+
+void platformPollInput(uint64_t &down, uint64_t &held) {
+  padUpdate(&pad);
+  down = padGetButtonsDown(&pad);
+  held = padGetButtons(&pad);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Framebuffer
+// ─────────────────────────────────────────────────────────────────────────────
+bool platformFramebufferInit() {
+  if (R_FAILED(framebufferCreate(&fb, nwindowGetDefault(), SCREEN_W, SCREEN_H,
+                                 PIXEL_FORMAT_RGBA_8888, 2)))
+    return false;
+  framebufferMakeLinear(&fb);
+
+  // When nothing on screen changes the reader skips the frame entirely and
+  // sleeps until the next vsync instead, so an idle reader costs next to no
+  // CPU.
+  haveDisplay = R_SUCCEEDED(viOpenDefaultDisplay(&display));
+  haveVsync =
+      haveDisplay && R_SUCCEEDED(viGetDisplayVsyncEvent(&display, &vsyncEvent));
+  return true;
+}
+
+void platformFramebufferExit() {
+  if (haveVsync)
+    eventClose(&vsyncEvent);
+  if (haveDisplay)
+    viCloseDisplay(&display);
+  haveVsync = haveDisplay = false;
+  framebufferClose(&fb);
+}
+
+uint32_t *platformFrameBegin() {
+  u32 stride;
+  return (uint32_t *)framebufferBegin(&fb, &stride);
+}
+
+void platformFrameEnd() { framebufferEnd(&fb); }
+
+void platformWaitVsync() {
+  if (haveVsync)
+    eventWait(&vsyncEvent, UINT64_MAX);
+  else
+    svcSleepThread(16666667ULL);
+}
+#endif
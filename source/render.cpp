@@ -0,0 +1,668 @@
+// KatanaReaderNX – framebuffer renderer
+// See render.h. All blitters write RGBA8 pixels into a linear 1280×720 buffer.
+
+#include "render.h"
+#include "pixelpool.h"
+#include "trace.h"
+#include <algorithm>
+#ifdef __aarch64__
+#include <arm_neon.h>
+#endif
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decoded pages
+// ─────────────────────────────────────────────────────────────────────────────
+DecodedImage::~DecodedImage() {
+  pixelFree(pixels);
+  for (uint8_t *t : tiles)
+    pixelFree(t);
+  delete preview;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Page preparation
+// Done once per page on the cache worker, right after decoding: margins are
+// cropped, then the page is scaled to the size it is shown at.
+// ─────────────────────────────────────────────────────────────────────────────
+static const int CROP_TOLERANCE = 24; // per channel, for JPEG noise
+static const int CROP_PADDING = 8;    // pixels of margin kept around content
+
+static bool isContent(const uint8_t *p, const uint8_t *bg) {
+  return std::abs(p[0] - bg[0]) > CROP_TOLERANCE ||
+         std::abs(p[1] - bg[1]) > CROP_TOLERANCE ||
+         std::abs(p[2] - bg[2]) > CROP_TOLERANCE;
+}
+
+#ifdef __aarch64__
+// Per-channel distance of four pixels from `bgv`, alpha zeroed so it is
+// ignored the same way isContent ignores it.
+static uint8x16_t colourDiff(const uint8_t *px, uint8x16_t bgv) {
+  uint8x16_t rgb = vreinterpretq_u8_u32(vdupq_n_u32(0x00FFFFFF));
+  return vandq_u8(vabdq_u8(vld1q_u8(px), bgv), rgb);
+}
+#endif
+
+// Index of the first of `n` pixels that isn't background, or n. Four pixels
+// at a time with NEON on the Switch.
+static int firstContent(const uint8_t *px, int n, const uint8_t *bg) {
+  int i = 0;
+#ifdef __aarch64__
+  uint32_t bgPixel;
+  memcpy(&bgPixel, bg, 4);
+  uint8x16_t bgv = vreinterpretq_u8_u32(vdupq_n_u32(bgPixel));
+  uint8x16_t tol = vdupq_n_u8(CROP_TOLERANCE);
+  for (; i + 4 <= n; i += 4)
+    if (vmaxvq_u8(vcgtq_u8(colourDiff(px + i * 4, bgv), tol)))
+      break;
+#endif
+  for (; i < n; i++)
+    if (isContent(px + i * 4, bg))
+      return i;
+  return n;
+}
+
+// One past the last of `n` pixels that isn't background, or 0.
+static int lastContent(const uint8_t *px, int n, const uint8_t *bg) {
+#ifdef __aarch64__
+  uint32_t bgPixel;
+  memcpy(&bgPixel, bg, 4);
+  uint8x16_t bgv = vreinterpretq_u8_u32(vdupq_n_u32(bgPixel));
+  uint8x16_t tol = vdupq_n_u8(CROP_TOLERANCE);
+  for (; n >= 4; n -= 4)
+    if (vmaxvq_u8(vcgtq_u8(colourDiff(px + (n - 4) * 4, bgv), tol)))
+      break;
+#endif
+  for (; n > 0; n--)
+    if (isContent(px + (n - 1) * 4, bg))
+      return n;
+  return 0;
+}
+
+void cropMargins(DecodedImage &img) {
+  int w = img.w, h = img.h;
+  if (w < 64 || h < 64)
+    return;
+  auto row = [&](int y) { return img.pixels + (size_t)y * w * 4; };
+
+  // The background is whatever all four corners agree on, if it is close to
+  // white or black; anything else is art running off the page.
+  const uint8_t *bg = row(0);
+  const uint8_t *corners[] = {row(0) + (w - 1) * 4, row(h - 1),
+                              row(h - 1) + (w - 1) * 4};
+  for (const uint8_t *c : corners)
+    if (isContent(c, bg))
+      return;
+  int lum = bg[0] + bg[1] + bg[2];
+  if (lum > 55 * 3 && lum < 200 * 3)
+    return;
+  TRACE_SCOPE("cropMargins");
+
+  int top = 0, bottom = h;
+  while (top < h && firstContent(row(top), w, bg) == w)
+    top++;
+  if (top == h)
+    return; // blank page
+  while (firstContent(row(bottom - 1), w, bg) == w)
+    bottom--;
+
+  // Each row only needs scanning outside the box found so far
+  int left = w, right = 0;
+  for (int y = top; y < bottom; y++) {
+    left = firstContent(row(y), left, bg);
+    right += lastContent(row(y) + right * 4, w - right, bg);
+  }
+
+  left = std::max(left - CROP_PADDING, 0);
+  top = std::max(top - CROP_PADDING, 0);
+  right = std::min(right + CROP_PADDING, w);
+  bottom = std::min(bottom + CROP_PADDING, h);
+  int cw = right - left, ch = bottom - top;
+  if (cw == w && ch == h)
+    return;
+  auto *out = (uint8_t *)pixelAlloc((size_t)cw * ch * 4);
+  if (!out)
+    return;
+  for (int y = 0; y < ch; y++)
+    memcpy(out + (size_t)y * cw * 4, row(top + y) + left * 4, (size_t)cw * 4);
+  pixelFree(img.pixels);
+  img.pixels = out;
+  img.w = cw;
+  img.h = ch;
+}
+
+bool scalerBegin(RowScaler &s, int w, int h, int dw, int dh) {
+  s.out = (uint8_t *)pixelAlloc((size_t)dw * dh * 4);
+  if (!s.out)
+    return false;
+  s.w = w;
+  s.h = h;
+  s.dw = dw;
+  s.dh = dh;
+  s.row = s.y = 0;
+  // Destination column x averages source columns [col[x], col[x + 1])
+  s.col.resize(dw + 1);
+  for (int x = 0; x <= dw; x++)
+    s.col[x] = (int)((int64_t)x * w / dw);
+  s.sum.assign((size_t)dw * 3, 0);
+  return true;
+}
+
+void scalerRow(RowScaler &s, const uint8_t *src) {
+  for (int x = 0; x < s.dw; x++)
+    for (int c = s.col[x]; c < s.col[x + 1]; c++) {
+      s.sum[x * 3] += src[c * 4];
+      s.sum[x * 3 + 1] += src[c * 4 + 1];
+      s.sum[x * 3 + 2] += src[c * 4 + 2];
+    }
+  s.row++;
+  // Emit the output row once its last source row is in
+  int r0 = (int)((int64_t)s.y * s.h / s.dh);
+  int r1 = (int)((int64_t)(s.y + 1) * s.h / s.dh);
+  if (s.row < r1)
+    return;
+  uint8_t *dst = s.out + (size_t)s.y++ * s.dw * 4;
+  for (int x = 0; x < s.dw; x++) {
+    uint32_t n = (r1 - r0) * (s.col[x + 1] - s.col[x]);
+    dst[x * 4] = s.sum[x * 3] / n;
+    dst[x * 4 + 1] = s.sum[x * 3 + 1] / n;
+    dst[x * 4 + 2] = s.sum[x * 3 + 2] / n;
+    dst[x * 4 + 3] = 0xFF;
+  }
+  std::fill(s.sum.begin(), s.sum.end(), 0);
+}
+
+void fitToScreen(DecodedImage &img, float detail) {
+  if (!img.pixels)
+    return; // tiled pages are only ever fitted while whole
+  float scale =
+      std::max((float)SCREEN_H / img.w, (float)SCREEN_W / img.h) * detail;
+  if (scale >= 1.0f)
+    return;
+  TRACE_SCOPE("fitToScreen");
+  RowScaler scaler;
+  if (!scalerBegin(scaler, img.w, img.h, std::max(1, (int)(img.w * scale)),
+                   std::max(1, (int)(img.h * scale))))
+    return;
+  for (int y = 0; y < img.h; y++)
+    scalerRow(scaler, img.pixels + (size_t)y * img.w * 4);
+  pixelFree(img.pixels);
+  img.pixels = scaler.out;
+  img.w = scaler.dw;
+  img.h = scaler.dh;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tall pages
+// ─────────────────────────────────────────────────────────────────────────────
+bool pageTiled(int w, int h) {
+  int64_t limit = (int64_t)TILE_MIN_SCREENS * SCREEN_W;
+  return h > limit && (int64_t)h * SCREEN_H > limit * w;
+}
+
+DecodedImage *tiledPage(int w, int h, RowScaler &scaler) {
+  // The preview is the page as page mode shows it: its height fitted to the
+  // screen width
+  int pw = std::max(1, (int)((int64_t)w * SCREEN_W / h));
+  if (!scalerBegin(scaler, w, h, pw, SCREEN_W))
+    return nullptr;
+  auto *di = new DecodedImage();
+  di->w = w;
+  di->h = h;
+  di->tiles.assign((h + TILE_ROWS - 1) / TILE_ROWS, nullptr);
+  di->preview = new DecodedImage();
+  di->preview->pixels = scaler.out;
+  di->preview->w = pw;
+  di->preview->h = SCREEN_W;
+  return di;
+}
+
+DecodedImage *tilePage(const DecodedImage &img) {
+  TRACE_SCOPE("tilePage");
+  RowScaler scaler;
+  DecodedImage *di = tiledPage(img.w, img.h, scaler);
+  if (di)
+    for (int y = 0; y < img.h; y++)
+      scalerRow(scaler, img.pixels + (size_t)y * img.w * 4);
+  return di;
+}
+
+// Row y of a page, or nullptr when it is in a tile that isn't decoded.
+static const uint8_t *pageRow(const DecodedImage &img, int y) {
+  if (img.pixels)
+    return img.pixels + (size_t)y * img.w * 4;
+  const uint8_t *tile = img.tiles[y / TILE_ROWS];
+  return tile ? tile + (size_t)(y % TILE_ROWS) * img.w * 4 : nullptr;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Blit RGBA pixels to the native libnx framebuffer in portrait mode.
+// The Switch framebuffer is RGBA8 linear at 1280×720.
+// We rotate the image 90° clockwise so a tall manga strip fills the screen
+// when the user holds the Switch sideways (Tate/Portrait mode).
+// ─────────────────────────────────────────────────────────────────────────────
+void blitPortrait(uint32_t *fb, const DecodedImage &img, int scrollY,
+                  const Rect &clip) {
+  if (img.preview)
+    return blitPortrait(fb, *img.preview, scrollY, clip);
+  TRACE_SCOPE("blitPortrait");
+  // Scale so the original image height maps to SCREEN_W (720px)
+  // (we rotate 90°, so the image height becomes the display width)
+  float scaleY = (float)SCREEN_W / img.h; // fits height → screen width
+  float scaleX = scaleY;                  // keep aspect ratio
+  int dstH = (int)(img.w * scaleX);       // how tall on screen after rotation
+
+  for (int sy = clip.y0; sy < clip.y1; sy++) {
+    // Map screen column (sy) back through the 90° rotation
+    // rotated y on screen ↔ original x axis
+    int origX = (int)((sy - scrollY) / scaleX);
+    if (origX < 0 || origX >= img.w)
+      continue;
+
+    for (int sx = clip.x0; sx < clip.x1; sx++) {
+      // rotated x on screen ↔ original y axis (reversed)
+      int origY = img.h - 1 - (int)(sx / scaleY);
+      if (origY < 0 || origY >= img.h)
+        continue;
+
+      uint8_t *p = img.pixels + (origY * img.w + origX) * 4;
+      uint32_t colour = rgba8(p[0], p[1], p[2], 0xFF);
+      fb[sy * SCREEN_W + sx] = colour;
+    }
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Continuous (webtoon) strip
+// The whole chapter is treated as one tall strip made of every page laid end
+// to end. Each page is scaled so its width fills the 720px screen height and
+// its height runs along the 1280px screen width, with the top of the strip on
+// the right-hand side (same 90° clockwise rotation as blitPortrait).
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Length of a page along the strip once scaled to fit the screen height.
+int stripLength(const DecodedImage &img) {
+  return (int)((int64_t)img.h * SCREEN_H / img.w);
+}
+
+// Draw the part of one page that intersects the viewport. `top` is the strip
+// position of the page's first row relative to the top of the viewport and
+// may be negative when the page starts above it.
+void blitStrip(uint32_t *fb, const DecodedImage &img, int top,
+               const Rect &clip) {
+  // Screen column sx shows strip position SCREEN_W - 1 - sx
+  int len = stripLength(img);
+  int p0 = std::max(top, SCREEN_W - clip.x1);
+  int p1 = std::min(top + len, SCREEN_W - clip.x0);
+  if (p0 >= p1)
+    return;
+  TRACE_SCOPE("blitStrip");
+
+  // Source row for every visible strip position, computed once per page
+  // instead of once per pixel; nullptr for rows of tiles not decoded yet.
+  const uint8_t *srcRow[SCREEN_W];
+  for (int p = p0; p < p1; p++) {
+    int origY = (int)((int64_t)(p - top) * img.h / len);
+    srcRow[p] = pageRow(img, std::min(origY, img.h - 1));
+  }
+
+  for (int sy = clip.y0; sy < clip.y1; sy++) {
+    int origX = (int)((int64_t)sy * img.w / SCREEN_H) * 4;
+    uint32_t *row = fb + sy * SCREEN_W;
+    for (int p = p0; p < p1; p++) {
+      const uint8_t *src = srcRow[p];
+      row[SCREEN_W - 1 - p] =
+          src ? rgba8(src[origX], src[origX + 1], src[origX + 2], 0xFF)
+              : BACKGROUND;
+    }
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Scroll-blit
+// Scrolling by a few pixels leaves almost all of the previous frame valid, just
+// shifted. Each frame records which pages it drew and where; if the next frame
+// shows the same pages moved along the scroll axis, the old pixels are shifted
+// into place and only the newly exposed band is rendered from the pages.
+// ─────────────────────────────────────────────────────────────────────────────
+// Fill one run of pixels, 16 at a time with NEON stores on the Switch.
+static void fillRow(uint32_t *dst, int n, uint32_t colour) {
+#ifdef __aarch64__
+  uint32x4_t v = vdupq_n_u32(colour);
+  for (; n >= 16; n -= 16, dst += 16) {
+    vst1q_u32(dst, v);
+    vst1q_u32(dst + 4, v);
+    vst1q_u32(dst + 8, v);
+    vst1q_u32(dst + 12, v);
+  }
+#endif
+  std::fill(dst, dst + n, colour);
+}
+
+void fillRect(uint32_t *fb, const Rect &r, uint32_t colour) {
+  if (r.x0 >= r.x1)
+    return;
+  for (int y = r.y0; y < r.y1; y++)
+    fillRow(fb + y * SCREEN_W + r.x0, r.x1 - r.x0, colour);
+}
+
+// Screen rows [r0, r1) that blitPortrait writes for this scroll position.
+// Every column of those rows is covered, since the page height is scaled to
+// the full screen width.
+static void portraitRows(const DecodedImage &img, int scrollY, int &r0,
+                         int &r1) {
+  if (img.preview)
+    return portraitRows(*img.preview, scrollY, r0, r1);
+  float scaleX = (float)SCREEN_W / img.h; // same mapping as blitPortrait
+  r0 = SCREEN_H;
+  r1 = 0;
+  for (int sy = 0; sy < SCREEN_H; sy++) {
+    int origX = (int)((sy - scrollY) / scaleX);
+    if (origX >= 0 && origX < img.w) {
+      r0 = std::min(r0, sy);
+      r1 = sy + 1;
+    }
+  }
+}
+
+static void drawBand(uint32_t *fb, const FrameState &fs, const Rect &clip) {
+  // Each page covers a full span across the screen, so coverage reduces to
+  // intervals along the scroll axis: columns in continuous mode, rows in page
+  // mode. Only the gaps between them are cleared to the background.
+  struct Span {
+    int lo, hi;
+  };
+  Span spans[MAX_VISIBLE];
+  int n = 0;
+  for (int i = 0; i < fs.count; i++) {
+    const VisiblePage &v = fs.vis[i];
+    if (!v.img)
+      continue;
+    if (fs.continuous) {
+      int p0 = std::max(v.pos, 0);
+      int p1 = std::min(v.pos + stripLength(*v.img), SCREEN_W);
+      if (p0 < p1)
+        spans[n++] = {SCREEN_W - p1, SCREEN_W - p0};
+    } else {
+      int r0, r1;
+      portraitRows(*v.img, v.pos, r0, r1);
+      if (r0 < r1)
+        spans[n++] = {r0, r1};
+    }
+  }
+  std::sort(spans, spans + n,
+            [](const Span &a, const Span &b) { return a.lo < b.lo; });
+
+  int lo = fs.continuous ? clip.x0 : clip.y0;
+  int hi = fs.continuous ? clip.x1 : clip.y1;
+  auto clearGap = [&](int a, int b) {
+    a = std::max(a, lo);
+    b = std::min(b, hi);
+    if (a >= b)
+      return;
+    if (fs.continuous)
+      fillRect(fb, {a, clip.y0, b, clip.y1}, BACKGROUND);
+    else
+      fillRect(fb, {clip.x0, a, clip.x1, b}, BACKGROUND);
+  };
+  int edge = lo;
+  for (int i = 0; i < n; i++) {
+    clearGap(edge, spans[i].lo);
+    edge = std::max(edge, spans[i].hi);
+  }
+  clearGap(edge, hi);
+
+  for (int i = 0; i < fs.count; i++) {
+    const VisiblePage &v = fs.vis[i];
+    if (!v.img)
+      continue;
+    if (fs.continuous)
+      blitStrip(fb, *v.img, v.pos, clip);
+    else
+      blitPortrait(fb, *v.img, v.pos, clip);
+  }
+}
+
+static void drawBandJob(void *ctx, const Rect &band) {
+  auto *job = (std::pair<uint32_t *, const FrameState *> *)ctx;
+  drawBand(job->first, *job->second, band);
+}
+
+void drawFrame(uint32_t *fb, const FrameState &fs, const Rect &clip) {
+  if (rectEmpty(clip))
+    return;
+  TRACE_SCOPE("drawFrame");
+  std::pair<uint32_t *, const FrameState *> job(fb, &fs);
+  renderParallel(clip, drawBandJob, &job);
+}
+
+// Work out how far the content moved between two frames. Returns false when
+// the frames are not a pure shift of each other (different mode, a page
+// loaded, was evicted or gained tiles, nothing in common, or moved by a whole
+// screen or more).
+bool frameShift(const FrameState &prev, const FrameState &next, int &dx,
+                int &dy) {
+  if (!prev.buf || prev.continuous != next.continuous)
+    return false;
+
+  bool found = false;
+  int delta = 0;
+  for (int i = 0; i < next.count; i++) {
+    for (int j = 0; j < prev.count; j++) {
+      if (prev.vis[j].idx != next.vis[i].idx)
+        continue;
+      if (prev.vis[j].img != next.vis[i].img ||
+          prev.vis[j].tileVersion != next.vis[i].tileVersion)
+        return false;
+      int d = next.continuous ? prev.vis[j].pos - next.vis[i].pos
+                              : next.vis[i].pos - prev.vis[j].pos;
+      if (found && d != delta)
+        return false;
+      found = true;
+      delta = d;
+    }
+  }
+  if (!found)
+    return false;
+
+  // In continuous mode the strip runs along screen columns, in page mode the
+  // scroll moves along screen rows.
+  dx = next.continuous ? delta : 0;
+  dy = next.continuous ? 0 : delta;
+  return std::abs(dx) < SCREEN_W && std::abs(dy) < SCREEN_H;
+}
+
+// Copy `src` into `dst` moved by (dx, dy). Either dx or dy must be zero.
+// `src` may equal `dst` (libnx linear framebuffers hand back the same shadow
+// buffer every frame), so overlapping copies go through memmove.
+void shiftFrame(uint32_t *dst, const uint32_t *src, int dx, int dy) {
+  if (dx == 0 && dy == 0 && dst == src)
+    return;
+  if (dy > 0) {
+    memmove(dst + dy * SCREEN_W, src,
+            (size_t)(SCREEN_H - dy) * SCREEN_W * sizeof(uint32_t));
+  } else if (dy < 0) {
+    memmove(dst, src - dy * SCREEN_W,
+            (size_t)(SCREEN_H + dy) * SCREEN_W * sizeof(uint32_t));
+  } else {
+    size_t bytes = (size_t)(SCREEN_W - std::abs(dx)) * sizeof(uint32_t);
+    for (int y = 0; y < SCREEN_H; y++) {
+      const uint32_t *s = src + y * SCREEN_W;
+      uint32_t *d = dst + y * SCREEN_W;
+      if (dx >= 0)
+        memmove(d + dx, s, bytes);
+      else
+        memmove(d, s - dx, bytes);
+    }
+  }
+}
+
+// True when `next` would draw exactly the same pixels as `prev`.
+bool frameUnchanged(const FrameState &prev, const FrameState &next) {
+  if (!prev.buf || prev.continuous != next.continuous ||
+      prev.count != next.count)
+    return false;
+  for (int i = 0; i < next.count; i++) {
+    const VisiblePage &a = prev.vis[i], &b = next.vis[i];
+    if (a.idx != b.idx || a.img != b.img || a.pos != b.pos ||
+        a.tileVersion != b.tileVersion)
+      return false;
+  }
+  return true;
+}
+
+// The band a shift of (dx, dy) leaves uncovered.
+Rect exposedBand(int dx, int dy) {
+  if (dx > 0)
+    return {0, 0, dx, SCREEN_H};
+  if (dx < 0)
+    return {SCREEN_W + dx, 0, SCREEN_W, SCREEN_H};
+  if (dy > 0)
+    return {0, 0, SCREEN_W, dy};
+  if (dy < 0)
+    return {0, SCREEN_H + dy, SCREEN_W, SCREEN_H};
+  return {0, 0, 0, 0};
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Render worker team
+// Workers are started once and parked on a condition variable between frames.
+// Each job publishes its bands, bumps the generation and runs band 0 on the
+// calling thread; workers take the remaining bands and count `pending` down.
+// The caller spins briefly on `pending` as the barrier, since every band is an
+// equal slice of the same work, and only sleeps if a worker is running late.
+// ─────────────────────────────────────────────────────────────────────────────
+static const int PARALLEL_MIN_PIXELS = 64 * 1024; // smaller jobs stay serial
+static const int BARRIER_SPINS = 4096;            // polls before sleeping
+
+struct RenderTeam {
+  int threads = 1;
+  std::mutex mtx;
+  std::condition_variable cv;     // workers wait here for a job
+  std::condition_variable doneCv; // caller waits here for late workers
+  uint32_t generation = 0; // bumped once per job, guarded by mtx
+  uint32_t startGeneration = 0; // generation when the workers were started
+  bool quit = false;
+  std::atomic<int> pending{0};
+  void (*fn)(void *, const Rect &) = nullptr;
+  void *ctx = nullptr;
+  Rect bands[MAX_RENDER_THREADS];
+#ifdef __SWITCH__
+  Thread workers[MAX_RENDER_THREADS - 1];
+#else
+  std::thread workers[MAX_RENDER_THREADS - 1];
+#endif
+};
+static RenderTeam team;
+
+static void workerLoop(int band) {
+  uint32_t seen = team.startGeneration;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(team.mtx);
+      team.cv.wait(lock,
+                   [&] { return team.quit || team.generation != seen; });
+      if (team.quit)
+        return;
+      seen = team.generation;
+    }
+    team.fn(team.ctx, team.bands[band]);
+    if (team.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lock(team.mtx);
+      team.doneCv.notify_one();
+    }
+  }
+}
+
+#ifdef __SWITCH__
+static void workerEntry(void *arg) { workerLoop((int)(intptr_t)arg); }
+#endif
+
+static void stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(team.mtx);
+    team.quit = true;
+  }
+  team.cv.notify_all();
+  for (int i = 0; i < team.threads - 1; i++) {
+#ifdef __SWITCH__
+    threadWaitForExit(&team.workers[i]);
+    threadClose(&team.workers[i]);
+#else
+    team.workers[i].join();
+#endif
+  }
+  team.quit = false;
+  team.threads = 1;
+}
+
+void renderSetThreads(int n) {
+  n = std::max(1, std::min(n, MAX_RENDER_THREADS));
+  if (n == team.threads)
+    return;
+  stopWorkers();
+
+  // Workers count jobs from the current generation rather than reading it
+  // when they first run, so a job published before a worker gets scheduled
+  // is not missed.
+  team.startGeneration = team.generation;
+  int started = 1;
+  for (int i = 1; i < n; i++) {
+#ifdef __SWITCH__
+    // Pin worker i to core i; the main thread runs on core 0.
+    Thread *t = &team.workers[i - 1];
+    if (R_FAILED(threadCreate(t, workerEntry, (void *)(intptr_t)i, NULL,
+                              0x10000, 0x2C, i)))
+      break;
+    threadStart(t);
+#else
+    team.workers[i - 1] = std::thread(workerLoop, i);
+#endif
+    started++;
+  }
+  team.threads = started;
+}
+
+int renderThreads() { return team.threads; }
+
+void renderParallel(const Rect &clip,
+                    void (*fn)(void *ctx, const Rect &band), void *ctx) {
+  int n = team.threads;
+  int rows = clip.y1 - clip.y0;
+  if (n <= 1 || rows < n ||
+      (int64_t)rows * (clip.x1 - clip.x0) < PARALLEL_MIN_PIXELS) {
+    fn(ctx, clip);
+    return;
+  }
+
+  for (int i = 0; i < n; i++)
+    team.bands[i] = {clip.x0, clip.y0 + rows * i / n, clip.x1,
+                     clip.y0 + rows * (i + 1) / n};
+  team.pending.store(n - 1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(team.mtx);
+    team.fn = fn;
+    team.ctx = ctx;
+    team.generation++;
+  }
+  team.cv.notify_all();
+
+  fn(ctx, team.bands[0]);
+  for (int i = 0; i < BARRIER_SPINS; i++)
+    if (team.pending.load(std::memory_order_acquire) == 0)
+      return;
+  std::unique_lock<std::mutex> lock(team.mtx);
+  team.doneCv.wait(lock, [] {
+    return team.pending.load(std::memory_order_acquire) == 0;
+  });
+}
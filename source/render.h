@@ -0,0 +1,164 @@
+// KatanaReaderNX – framebuffer renderer
+// Rotating blitters, scroll-blit and damage tracking for the 1280×720 RGBA8
+// framebuffer. Nothing in here depends on libnx so it can be benchmarked on a
+// normal workstation.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Display constants
+// ─────────────────────────────────────────────────────────────────────────────
+static const int SCREEN_W = 1280;
+static const int SCREEN_H = 720;
+
+// Destination rectangle in framebuffer pixels, half-open [x0,x1) × [y0,y1).
+// Blitters only touch pixels inside the rectangle they are given.
+struct Rect {
+  int x0, y0, x1, y1;
+};
+static const Rect FULL_SCREEN = {0, 0, SCREEN_W, SCREEN_H};
+
+inline bool rectEmpty(const Rect &r) { return r.x0 >= r.x1 || r.y0 >= r.y1; }
+
+// Smallest rectangle containing both (an empty one contributes nothing)
+inline Rect rectUnion(const Rect &a, const Rect &b) {
+  if (rectEmpty(a))
+    return b;
+  if (rectEmpty(b))
+    return a;
+  return {a.x0 < b.x0 ? a.x0 : b.x0, a.y0 < b.y0 ? a.y0 : b.y0,
+          a.x1 > b.x1 ? a.x1 : b.x1, a.y1 > b.y1 ? a.y1 : b.y1};
+}
+
+inline Rect rectIntersect(const Rect &a, const Rect &b) {
+  return {a.x0 > b.x0 ? a.x0 : b.x0, a.y0 > b.y0 ? a.y0 : b.y0,
+          a.x1 < b.x1 ? a.x1 : b.x1, a.y1 < b.y1 ? a.y1 : b.y1};
+}
+
+// Same byte order as libnx RGBA8(): R in the low byte, A in the high byte.
+constexpr uint32_t rgba8(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+  return (r & 0xff) | ((g & 0xff) << 8) | ((b & 0xff) << 16) |
+         ((a & 0xff) << 24);
+}
+
+static const uint32_t BACKGROUND = rgba8(15, 15, 25, 255);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Decoded page pixels (RGBA8, allocated from the pixel pool, see pixelpool.h)
+// ─────────────────────────────────────────────────────────────────────────────
+struct DecodedImage {
+  uint8_t *pixels = nullptr; // every row, or nullptr for a tiled page
+  int w = 0, h = 0;
+  // Tiled pages only (see below)
+  std::vector<uint8_t *> tiles;    // TILE_ROWS rows each, nullptr until decoded
+  DecodedImage *preview = nullptr; // whole page fitted for page mode
+  unsigned tileVersion = 0;        // bumped whenever a tile is added
+  ~DecodedImage();
+};
+
+// Trim the uniform white or black margins scans often carry, so they are
+// never stored, packed or blitted and the content fills the screen instead.
+// Pages whose corners don't agree on such a background are left alone.
+void cropMargins(DecodedImage &img);
+
+// Box-filter a page down to the smallest size that still has a source pixel
+// for every screen pixel in both reading modes (width fitted to the screen
+// height, height fitted to the screen width). Smaller pages are left alone.
+// A `detail` below 1 scales that target down too, for when memory is short.
+void fitToScreen(DecodedImage &img, float detail = 1.0f);
+
+// Box filter fed one source row at a time, top to bottom, for pages that are
+// never in memory whole. Output row y averages source rows
+// [y * h / dh, (y + 1) * h / dh); only scales down.
+struct RowScaler {
+  int w = 0, h = 0, dw = 0, dh = 0;
+  int row = 0;            // source rows fed so far
+  int y = 0;              // output row they are being summed into
+  uint8_t *out = nullptr; // dw×dh RGBA8 from the pixel pool
+  std::vector<int> col;
+  std::vector<uint32_t> sum;
+};
+bool scalerBegin(RowScaler &s, int w, int h, int dw, int dh);
+void scalerRow(RowScaler &s, const uint8_t *row);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Tall pages
+// Webtoon pages run to 15000 rows and more, of which continuous mode only
+// ever shows a screenful. Pages longer than TILE_MIN_SCREENS screens along
+// the strip are kept as tiles of TILE_ROWS rows instead: the page cache
+// (main.cpp) decodes only the tiles near the viewport from the packed page
+// and frees the rest, and page mode draws the preview. Rows in tiles that
+// aren't decoded are drawn as background.
+// ─────────────────────────────────────────────────────────────────────────────
+static const int TILE_ROWS = 256; // a 720-wide tile fits a 1 MB pool slab
+static const int TILE_MIN_SCREENS = 4;
+
+bool pageTiled(int w, int h);
+inline bool isTiled(const DecodedImage &img) { return !img.tiles.empty(); }
+
+// An empty tiled page of w×h with its preview buffer allocated; feed every
+// row of the page to `scaler` to fill the preview. nullptr if out of memory.
+DecodedImage *tiledPage(int w, int h, RowScaler &scaler);
+// The tiled form of a fully decoded page, with no tiles decoded.
+DecodedImage *tilePage(const DecodedImage &img);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Blitters
+// ─────────────────────────────────────────────────────────────────────────────
+// Page mode: image height fitted to the screen width, scrolled along rows.
+void blitPortrait(uint32_t *fb, const DecodedImage &img, int scrollY,
+                  const Rect &clip = FULL_SCREEN);
+
+// Continuous mode: length of a page along the strip once its width is fitted
+// to the screen height, and a blit of the part of it inside the viewport.
+int stripLength(const DecodedImage &img);
+void blitStrip(uint32_t *fb, const DecodedImage &img, int top,
+               const Rect &clip = FULL_SCREEN);
+
+void fillRect(uint32_t *fb, const Rect &r, uint32_t colour);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Frame layout, scroll-blit and damage tracking
+// ─────────────────────────────────────────────────────────────────────────────
+static const int MAX_VISIBLE = 64; // pages drawn at most in one viewport
+
+struct VisiblePage {
+  int idx;
+  const DecodedImage *img; // nullptr while the page is still loading
+  int pos;                 // strip top (continuous) or scrollY (page mode)
+  unsigned tileVersion;    // img->tileVersion when the frame was laid out
+};
+
+struct FrameState {
+  uint32_t *buf = nullptr; // framebuffer this frame was drawn into
+  bool continuous = false;
+  int count = 0;
+  VisiblePage vis[MAX_VISIBLE];
+};
+
+// Render everything `fs` shows inside `clip`, background included. Large
+// areas are split into horizontal bands across the render worker team.
+void drawFrame(uint32_t *fb, const FrameState &fs, const Rect &clip);
+
+bool frameShift(const FrameState &prev, const FrameState &next, int &dx,
+                int &dy);
+bool frameUnchanged(const FrameState &prev, const FrameState &next);
+void shiftFrame(uint32_t *dst, const uint32_t *src, int dx, int dy);
+Rect exposedBand(int dx, int dy);
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Render worker team
+// ─────────────────────────────────────────────────────────────────────────────
+static const int MAX_RENDER_THREADS = 3; // cores available to applications
+
+// Number of threads (including the caller) used by drawFrame. Workers are
+// created once here and parked between frames; 1 stops them all.
+void renderSetThreads(int n);
+int renderThreads();
+
+// Run fn(ctx, band) over `clip` split into one horizontal band per thread and
+// return once every band is done.
+void renderParallel(const Rect &clip,
+                    void (*fn)(void *ctx, const Rect &band), void *ctx);
@@ -0,0 +1,105 @@
+// KatanaReaderNX – resume from the last-read position
+// See resume.h.
+
+#include "resume.h"
+#include "platform.h"
+#include "writer.h"
+#include "nlohmann/json.hpp"
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <sys/stat.h>
+
+static std::string resumeDir() {
+  return std::string(platformDataDir()) + "/resume";
+}
+
+static std::string pagePath(int idx) {
+  char name[32];
+  snprintf(name, sizeof(name), "/page-%04d.bin", idx);
+  return resumeDir() + name;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Reading position
+// ─────────────────────────────────────────────────────────────────────────────
+// Every field present with the type resumeSave writes; json::value would
+// throw on a mismatch, and a hand-edited or truncated state.json must only
+// cost the resume, not the launch.
+static bool validState(const nlohmann::json &j) {
+  if (!j.is_object() || !j.contains("chapter") || !j["chapter"].is_string() ||
+      !j.contains("images") || !j["images"].is_array() ||
+      !j.contains("page") || !j["page"].is_number_integer() ||
+      !j.contains("continuous") || !j["continuous"].is_boolean() ||
+      !j.contains("offset") || !j["offset"].is_number_integer())
+    return false;
+  for (const auto &image : j["images"])
+    if (!image.is_string())
+      return false;
+  return true;
+}
+
+bool resumeLoad(ResumeState &state) {
+  std::ifstream in(resumeDir() + "/state.json");
+  if (!in)
+    return false;
+  nlohmann::json j = nlohmann::json::parse(in, nullptr, false);
+  if (j.is_discarded() || !validState(j)) {
+    printf("[resume] state.json is malformed, starting fresh\n");
+    return false;
+  }
+  state.chapter = j["chapter"].get<std::string>();
+  state.images = j["images"].get<std::vector<std::string>>();
+  state.page = j["page"].get<int>();
+  state.continuous = j["continuous"].get<bool>();
+  state.offset = j["offset"].get<int>();
+  return !state.chapter.empty();
+}
+
+void resumeSave(const ResumeState &state) {
+  mkdir(resumeDir().c_str(), 0777);
+  nlohmann::json j = {
+      {"chapter", state.chapter},     {"images", state.images},
+      {"page", state.page},           {"continuous", state.continuous},
+      {"offset", state.offset},
+  };
+  std::string text = j.dump(2) + "\n";
+  writerFile(resumeDir() + "/state.json",
+             std::vector<uint8_t>(text.begin(), text.end()), WRITE_HIGH);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Saved pages
+// ─────────────────────────────────────────────────────────────────────────────
+bool resumeHasPage(int idx) {
+  struct stat st;
+  return stat(pagePath(idx).c_str(), &st) == 0 && st.st_size > 0;
+}
+
+bool resumeReadPage(int idx, std::vector<uint8_t> &data) {
+  std::ifstream in(pagePath(idx), std::ios::binary);
+  if (!in)
+    return false;
+  data.assign(std::istreambuf_iterator<char>(in),
+              std::istreambuf_iterator<char>());
+  return !data.empty();
+}
+
+void resumeWritePage(int idx, std::vector<uint8_t> data) {
+  mkdir(resumeDir().c_str(), 0777);
+  writerFile(pagePath(idx), std::move(data), WRITE_HIGH);
+}
+
+void resumePrunePages(int first, int last) {
+  std::string dir = resumeDir();
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return;
+  while (dirent *e = readdir(d)) {
+    int idx;
+    if (sscanf(e->d_name, "page-%d.bin", &idx) == 1 &&
+        (idx < first || idx > last))
+      remove((dir + "/" + e->d_name).c_str());
+  }
+  closedir(d);
+}
@@ -0,0 +1,35 @@
+// KatanaReaderNX – resume from the last-read position
+// On exit the reader saves the chapter, its page list and the reading
+// position; downloaded pages are kept as files next to it. On the next launch
+// of the same chapter the current page is decoded straight from those files
+// before any network activity, and its neighbours follow in the background.
+//
+// Everything lives under <data dir>/resume/: state.json, page-NNNN.bin (the
+// encoded page as downloaded) and snap-NNNN.bin (the decoded page, see
+// snapshot.h).
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ResumeState {
+  std::string chapter; // chapter URL
+  std::vector<std::string> images;
+  int page = 0;
+  bool continuous = true;
+  int offset = 0; // pageOffset (continuous) or scrollY (page mode)
+};
+
+bool resumeLoad(ResumeState &state);
+void resumeSave(const ResumeState &state);
+
+// Saved pages of the chapter in state.json. Writing and pruning are safe to
+// call from the cache worker; writes go through the disk writer (writer.h),
+// so prune only after writerStop.
+bool resumeHasPage(int idx);
+bool resumeReadPage(int idx, std::vector<uint8_t> &data);
+void resumeWritePage(int idx, std::vector<uint8_t> data);
+
+// Delete saved pages outside [first, last]; all of them with first > last.
+void resumePrunePages(int first, int last);
@@ -0,0 +1,185 @@
+// KatanaReaderNX – session record/replay
+// See session.h.
+
+#include "session.h"
+#include "platform.h"
+#include "startup.h"
+#include "writer.h"
+#include "nlohmann/json.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sys/stat.h>
+#include <thread>
+
+static const uint64_t FRAME_BUDGET_NS = 16666667ull; // 60 Hz
+
+enum SessionMode { SESSION_OFF, SESSION_RECORD, SESSION_REPLAY };
+
+struct InputRun {
+  int frames;
+  uint64_t held;
+};
+
+struct Session {
+  SessionMode mode = SESSION_OFF;
+  std::string dir;
+  int latencyMs = 0, kbps = 0;
+
+  std::mutex mtx; // responses are saved and loaded from the cache worker
+  std::map<std::string, std::string> files; // url -> body file under http/
+
+  std::vector<InputRun> input; // run-length encoded, main thread only
+  uint64_t frames = 0, framesOver = 0, worstFrameNs = 0;
+  std::atomic<uint64_t> bytes{0};
+};
+
+static Session session;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Set-up
+// ─────────────────────────────────────────────────────────────────────────────
+bool sessionRecord(const char *dir) {
+  session.dir = dir;
+  mkdir(dir, 0777);
+  mkdir((session.dir + "/http").c_str(), 0777);
+  FILE *index = fopen((session.dir + "/http/index.txt").c_str(), "w");
+  if (!index)
+    return false;
+  fclose(index);
+  session.mode = SESSION_RECORD;
+  return true;
+}
+
+bool sessionReplay(const char *dir, int latencyMs, int kbps) {
+  session.dir = dir;
+  FILE *f = fopen((session.dir + "/http/index.txt").c_str(), "r");
+  if (!f)
+    return false;
+  char line[4096], file[64];
+  size_t bytes;
+  int urlStart;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "%63s %zu %n", file, &bytes, &urlStart) < 2)
+      continue;
+    std::string url = line + urlStart;
+    while (!url.empty() && (url.back() == '\n' || url.back() == '\r'))
+      url.pop_back();
+    session.files[url] = file;
+  }
+  fclose(f);
+  session.latencyMs = latencyMs;
+  session.kbps = kbps;
+  session.mode = SESSION_REPLAY;
+  return true;
+}
+
+bool sessionReplaying() { return session.mode == SESSION_REPLAY; }
+
+void sessionInput(uint64_t held) {
+  if (session.mode != SESSION_RECORD)
+    return;
+  if (!session.input.empty() && session.input.back().held == held)
+    session.input.back().frames++;
+  else
+    session.input.push_back({1, held});
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// HTTP responses
+// ─────────────────────────────────────────────────────────────────────────────
+void sessionSaveResponse(const std::string &url,
+                         const std::vector<uint8_t> &body) {
+  if (session.mode != SESSION_RECORD || body.empty())
+    return;
+  std::lock_guard<std::mutex> lock(session.mtx);
+  if (session.files.count(url))
+    return; // pages evicted and fetched again only need saving once
+
+  // The disk writer puts each body on disk before its index line
+  char file[64], line[96];
+  snprintf(file, sizeof(file), "%04zu.bin", session.files.size());
+  snprintf(line, sizeof(line), "%s %zu ", file, body.size());
+  session.files[url] = file;
+  writerFile(session.dir + "/http/" + file, body, WRITE_HIGH);
+  writerAppend(session.dir + "/http/index.txt", line + url + "\n");
+}
+
+std::vector<uint8_t> sessionLoadResponse(const std::string &url) {
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(session.mtx);
+    auto it = session.files.find(url);
+    if (it != session.files.end())
+      path = session.dir + "/http/" + it->second;
+  }
+
+  std::vector<uint8_t> body;
+  if (!path.empty()) {
+    std::ifstream in(path, std::ios::binary);
+    body.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+  }
+
+  // Shaping: a fixed round trip plus the transfer time at the capped rate
+  uint64_t delayUs = (uint64_t)session.latencyMs * 1000;
+  if (session.kbps > 0)
+    delayUs += body.size() * 1000000ull / ((uint64_t)session.kbps * 1024);
+  if (delayUs)
+    std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+  return body;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Metrics and report
+// ─────────────────────────────────────────────────────────────────────────────
+void sessionFrame(uint64_t costNs) {
+  session.frames++;
+  if (costNs > FRAME_BUDGET_NS)
+    session.framesOver++;
+  if (costNs > session.worstFrameNs)
+    session.worstFrameNs = costNs;
+}
+
+void sessionBytes(size_t bytes) {
+  session.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void sessionFinish() {
+  if (session.mode == SESSION_OFF)
+    return;
+
+  if (session.mode == SESSION_RECORD) {
+    if (FILE *f = fopen((session.dir + "/input.txt").c_str(), "w")) {
+      fprintf(f, "# recorded input: <frames> [BUTTON ...]\n");
+      for (const InputRun &run : session.input) {
+        fprintf(f, "%d", run.frames);
+        for (const auto &b : BUTTON_NAMES)
+          if (run.held & b.bit)
+            fprintf(f, " %s", b.name);
+        fprintf(f, "\n");
+      }
+      fclose(f);
+    }
+  }
+
+  nlohmann::json report = {
+      {"mode", session.mode == SESSION_RECORD ? "record" : "replay"},
+      {"ttfpMs", startupTtfpNs() / 1e6},
+      {"frames", session.frames},
+      {"framesOverBudget", session.framesOver},
+      {"budgetMs", FRAME_BUDGET_NS / 1e6},
+      {"worstFrameMs", session.worstFrameNs / 1e6},
+      {"bytes", session.bytes.load()},
+  };
+  printf("[session] ttfp %.1f ms, %llu/%llu frames over %.1f ms (worst "
+         "%.1f ms), %llu bytes\n",
+         startupTtfpNs() / 1e6, (unsigned long long)session.framesOver,
+         (unsigned long long)session.frames, FRAME_BUDGET_NS / 1e6,
+         session.worstFrameNs / 1e6, (unsigned long long)session.bytes.load());
+  std::ofstream(session.dir + "/report.json") << report.dump(2) << "\n";
+  session.mode = SESSION_OFF;
+}
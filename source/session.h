@@ -0,0 +1,43 @@
+// KatanaReaderNX – session record/replay
+// A recorded session is a directory holding everything needed to run the
+// reader again without the network or a person at the controls:
+//
+//   input.txt        buttons held on every main loop iteration, in the host
+//                    input script format (see platform_host.cpp)
+//   http/index.txt   one "<file> <bytes> <url>" line per recorded response
+//   http/NNNN.bin    response bodies
+//
+// While replaying, downloads are answered from http/ (optionally shaped with
+// a fixed latency and bandwidth cap) and the host feeds input.txt back as its
+// input script, so the same frames are produced in the same order. On exit
+// the session reports time-to-first-page (see startup.h), frames over budget
+// and bytes transferred.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+bool sessionRecord(const char *dir);
+bool sessionReplay(const char *dir, int latencyMs, int kbps);
+bool sessionReplaying();
+
+// Input for one main loop iteration (recording only).
+void sessionInput(uint64_t held);
+
+// Called by downloadRaw with every completed response while recording.
+void sessionSaveResponse(const std::string &url,
+                         const std::vector<uint8_t> &body);
+// Recorded body for `url` while replaying, after the shaping delay. Empty if
+// the session never fetched it.
+std::vector<uint8_t> sessionLoadResponse(const std::string &url);
+
+// Regression metrics
+void sessionFrame(uint64_t costNs);
+void sessionBytes(size_t bytes);
+
+// Write input.txt (recording) and the report (both modes), printed to stdout
+// and saved as report.json in the session directory. Call after writerStop so
+// every recorded response is on disk.
+void sessionFinish();
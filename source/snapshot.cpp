@@ -0,0 +1,277 @@
+// KatanaReaderNX – pre-decoded page snapshots
+// See snapshot.h.
+
+#include "snapshot.h"
+#include "alloc.h"
+#include "pixelpool.h"
+#include "platform.h"
+#include "trace.h"
+#include "writer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+static const uint32_t SNAP_VERSION = 1;
+static const int BAND_ROWS = 64;
+// Pages are packed once fitted (render.h), so one side is within the screen;
+// the other runs along the strip, which no page comes near this
+static const uint32_t SNAP_MAX_LENGTH = 1u << 16;
+
+struct SnapHeader {
+  char magic[4];
+  uint32_t version, channels, w, h, bandRows, bands;
+};
+
+static std::string snapDir() {
+  return std::string(platformDataDir()) + "/resume";
+}
+
+static std::string snapPath(int idx) {
+  char name[32];
+  snprintf(name, sizeof(name), "/snap-%04d.bin", idx);
+  return snapDir() + name;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Packing
+// ─────────────────────────────────────────────────────────────────────────────
+static bool isGray(const DecodedImage &img) {
+  const uint8_t *p = img.pixels;
+  for (size_t i = 0, n = (size_t)img.w * img.h; i < n; i++, p += 4)
+    if (p[0] != p[1] || p[0] != p[2])
+      return false;
+  return true;
+}
+
+std::vector<uint8_t> snapshotPack(const DecodedImage &img) {
+  TRACE_SCOPE("snapshotPack");
+  SnapHeader hdr = {{'K', 'S', 'N', 'P'},
+                    SNAP_VERSION,
+                    isGray(img) ? 1u : 3u,
+                    (uint32_t)img.w,
+                    (uint32_t)img.h,
+                    BAND_ROWS,
+                    (uint32_t)((img.h + BAND_ROWS - 1) / BAND_ROWS)};
+  size_t at = sizeof(hdr) + hdr.bands * sizeof(uint32_t);
+  std::vector<uint8_t> packed(at),
+      band((size_t)BAND_ROWS * img.w * hdr.channels);
+  packed.reserve(at + (size_t)img.w * img.h * hdr.channels / 4);
+  memcpy(packed.data(), &hdr, sizeof(hdr));
+
+  for (uint32_t b = 0; b < hdr.bands; b++) {
+    int rows = std::min(BAND_ROWS, img.h - (int)b * BAND_ROWS);
+    const uint8_t *src = img.pixels + (size_t)b * BAND_ROWS * img.w * 4;
+    uint8_t *dst = band.data();
+    for (size_t i = 0, count = (size_t)rows * img.w; i < count; i++, src += 4)
+      for (uint32_t c = 0; c < hdr.channels; c++)
+        *dst++ = src[c];
+
+    // Fastest level: packing happens on every page load and the inflate
+    // speed hardly depends on it
+    uLong raw = dst - band.data();
+    uLongf n = compressBound(raw);
+    packed.resize(at + n);
+    if (compress2(packed.data() + at, &n, band.data(), raw, Z_BEST_SPEED) !=
+        Z_OK)
+      return {};
+    uint32_t size = (uint32_t)n;
+    memcpy(packed.data() + sizeof(hdr) + b * sizeof(uint32_t), &size,
+           sizeof(size));
+    at += n;
+    packed.resize(at);
+  }
+  return packed;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Unpacking
+// ─────────────────────────────────────────────────────────────────────────────
+// Header and band offsets of a packed page, checked against its size.
+struct SnapLayout {
+  SnapHeader hdr;
+  std::vector<size_t> offsets; // start of every band, then the end
+};
+
+static bool snapLayout(const std::vector<uint8_t> &packed, SnapLayout &l) {
+  SnapHeader &hdr = l.hdr;
+  if (packed.size() < sizeof(hdr))
+    return false;
+  memcpy(&hdr, packed.data(), sizeof(hdr));
+  if (memcmp(hdr.magic, "KSNP", 4) != 0 || hdr.version != SNAP_VERSION ||
+      (hdr.channels != 1 && hdr.channels != 3) || !hdr.w || !hdr.h ||
+      hdr.w > SNAP_MAX_LENGTH || hdr.h > SNAP_MAX_LENGTH ||
+      (hdr.w > SCREEN_H && hdr.h > SCREEN_W) || hdr.bandRows != BAND_ROWS ||
+      hdr.bands != (hdr.h + BAND_ROWS - 1) / BAND_ROWS)
+    return false;
+  size_t pos = sizeof(hdr) + (size_t)hdr.bands * sizeof(uint32_t);
+  if (packed.size() < pos)
+    return false;
+  l.offsets.resize(hdr.bands + 1);
+  for (uint32_t b = 0; b < hdr.bands; b++) {
+    uint32_t size;
+    memcpy(&size, packed.data() + sizeof(hdr) + b * sizeof(uint32_t),
+           sizeof(size));
+    l.offsets[b] = pos;
+    pos += size;
+    if (pos > packed.size())
+      return false;
+  }
+  l.offsets[hdr.bands] = pos;
+  return true;
+}
+
+// Inflate band `b` through `band` and expand it to RGBA8 rows at `dst`.
+static bool unpackBand(const std::vector<uint8_t> &packed,
+                       const SnapLayout &l, uint32_t b,
+                       std::vector<uint8_t> &band, uint8_t *dst) {
+  const SnapHeader &hdr = l.hdr;
+  uint32_t rows = std::min(hdr.bandRows, hdr.h - b * hdr.bandRows);
+  uLongf want = (uLongf)rows * hdr.w * hdr.channels, n = want;
+  if (uncompress(band.data(), &n, packed.data() + l.offsets[b],
+                 l.offsets[b + 1] - l.offsets[b]) != Z_OK ||
+      n != want)
+    return false;
+
+  // Expand to the RGBA8 layout the blitters read
+  const uint8_t *src = band.data();
+  for (size_t i = 0, count = (size_t)rows * hdr.w; i < count; i++) {
+    uint8_t r = src[0], g = hdr.channels == 3 ? src[1] : r,
+            bl = hdr.channels == 3 ? src[2] : r;
+    dst[0] = r;
+    dst[1] = g;
+    dst[2] = bl;
+    dst[3] = 0xFF;
+    src += hdr.channels;
+    dst += 4;
+  }
+  return true;
+}
+
+// A tall page is never unpacked whole: its bands only stream through the
+// preview, and tiles are unpacked later with snapshotUnpackRows.
+static DecodedImage *unpackTiled(const std::vector<uint8_t> &packed,
+                                 const SnapLayout &l) {
+  const SnapHeader &hdr = l.hdr;
+  RowScaler scaler;
+  DecodedImage *di = tiledPage(hdr.w, hdr.h, scaler);
+  if (!di)
+    return nullptr;
+  std::vector<uint8_t> band((size_t)hdr.bandRows * hdr.w * hdr.channels),
+      rows((size_t)hdr.bandRows * hdr.w * 4);
+  for (uint32_t b = 0; b < hdr.bands; b++) {
+    if (!unpackBand(packed, l, b, band, rows.data())) {
+      delete di;
+      return nullptr;
+    }
+    uint32_t count = std::min(hdr.bandRows, hdr.h - b * hdr.bandRows);
+    for (uint32_t r = 0; r < count; r++)
+      scalerRow(scaler, rows.data() + (size_t)r * hdr.w * 4);
+  }
+  return di;
+}
+
+DecodedImage *snapshotUnpack(const std::vector<uint8_t> &packed) {
+  TRACE_SCOPE("snapshotUnpack");
+  ALLOC_STAGE("decode");
+  SnapLayout l;
+  if (!snapLayout(packed, l))
+    return nullptr;
+  const SnapHeader &hdr = l.hdr;
+  if (pageTiled(hdr.w, hdr.h))
+    return unpackTiled(packed, l);
+
+  auto *di = new DecodedImage();
+  di->w = hdr.w;
+  di->h = hdr.h;
+  di->pixels = (uint8_t *)pixelAlloc((size_t)hdr.w * hdr.h * 4);
+  std::vector<uint8_t> band((size_t)hdr.bandRows * hdr.w * hdr.channels);
+  bool ok = di->pixels != nullptr;
+  for (uint32_t b = 0; ok && b < hdr.bands; b++)
+    ok = unpackBand(packed, l, b, band,
+                    di->pixels + (size_t)b * hdr.bandRows * hdr.w * 4);
+  if (!ok) {
+    delete di;
+    return nullptr;
+  }
+  return di;
+}
+
+bool snapshotUnpackRows(const std::vector<uint8_t> &packed, int row0,
+                        int count, uint8_t *out) {
+  TRACE_SCOPE("snapshotUnpackRows");
+  SnapLayout l;
+  if (!snapLayout(packed, l))
+    return false;
+  const SnapHeader &hdr = l.hdr;
+  if (row0 < 0 || count <= 0 || row0 + count > (int)hdr.h)
+    return false;
+  size_t rowBytes = (size_t)hdr.w * 4;
+  int row1 = row0 + count, bandRows = hdr.bandRows;
+  std::vector<uint8_t> band((size_t)bandRows * hdr.w * hdr.channels), rows;
+  for (int b = row0 / bandRows; b * bandRows < row1; b++) {
+    int first = b * bandRows, last = std::min(first + bandRows, (int)hdr.h);
+    // Bands wholly inside the range go straight to `out`
+    if (first >= row0 && last <= row1) {
+      if (!unpackBand(packed, l, b, band, out + (first - row0) * rowBytes))
+        return false;
+      continue;
+    }
+    rows.resize((size_t)bandRows * rowBytes);
+    if (!unpackBand(packed, l, b, band, rows.data()))
+      return false;
+    int from = std::max(first, row0), to = std::min(last, row1);
+    memcpy(out + (from - row0) * rowBytes,
+           rows.data() + (from - first) * rowBytes, (to - from) * rowBytes);
+  }
+  return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Files
+// ─────────────────────────────────────────────────────────────────────────────
+bool snapshotHas(int idx) {
+  struct stat st;
+  return stat(snapPath(idx).c_str(), &st) == 0 &&
+         st.st_size > (off_t)sizeof(SnapHeader);
+}
+
+// One read of the whole file; the SD card is much faster sequentially
+bool snapshotRead(int idx, std::vector<uint8_t> &packed) {
+  FILE *f = fopen(snapPath(idx).c_str(), "rb");
+  if (!f)
+    return false;
+  fseek(f, 0, SEEK_END);
+  packed.resize(std::max(ftell(f), 0L));
+  fseek(f, 0, SEEK_SET);
+  bool ok = fread(packed.data(), 1, packed.size(), f) == packed.size();
+  fclose(f);
+  return ok && !packed.empty();
+}
+
+void snapshotSave(int idx, std::vector<uint8_t> packed) {
+  if (packed.empty())
+    return;
+  mkdir(snapDir().c_str(), 0777);
+  writerFile(snapPath(idx), std::move(packed), WRITE_LOW);
+}
+
+void snapshotPrune(int first, int last) {
+  std::string dir = snapDir();
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return;
+  while (dirent *e = readdir(d)) {
+    int idx;
+    if (sscanf(e->d_name, "snap-%d.bin", &idx) == 1 &&
+        (idx < first || idx > last))
+      remove((dir + "/" + e->d_name).c_str());
+  }
+  closedir(d);
+}
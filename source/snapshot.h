@@ -0,0 +1,39 @@
+// KatanaReaderNX – pre-decoded page snapshots
+// Decoded pages packed display-ready: already scaled down by fitToScreen
+// (render.h) and one byte per pixel when grayscale, as most manga pages are,
+// in zlib-compressed bands of rows. Unpacking is far cheaper than decoding
+// the JPEG again. The same packed form is the reader's warm in-RAM tier (see
+// the page cache in main.cpp) and its second disk tier next to the saved
+// pages (resume.h), where a snapshot is read back with one sequential read.
+//
+// Files live under <data dir>/resume/snap-NNNN.bin:
+//
+//   header  "KSNP", version, channels (1 gray or 3 RGB), width, height,
+//           rows per band, band count – all uint32 little-endian
+//   sizes   compressed size of each band (uint32)
+//   bands   one zlib stream per band of rows, tightly packed pixels
+
+#pragma once
+#include "render.h"
+#include <cstdint>
+#include <vector>
+
+// Empty if compression failed.
+std::vector<uint8_t> snapshotPack(const DecodedImage &img);
+// nullptr if `packed` is damaged. Tall pages come back tiled (render.h) with
+// no tiles decoded.
+DecodedImage *snapshotUnpack(const std::vector<uint8_t> &packed);
+// Unpack rows [row0, row0 + count) into `out` (RGBA8, the page's width), for
+// the tiles of a tall page. Only the bands holding them are inflated.
+bool snapshotUnpackRows(const std::vector<uint8_t> &packed, int row0,
+                        int count, uint8_t *out);
+
+bool snapshotHas(int idx);
+bool snapshotRead(int idx, std::vector<uint8_t> &packed);
+
+// Queue a packed page with the disk writer (writer.h) at low priority; safe
+// to call from the cache worker.
+void snapshotSave(int idx, std::vector<uint8_t> packed);
+
+// Delete snapshots outside [first, last]; all of them with first > last.
+void snapshotPrune(int first, int last);
@@ -0,0 +1,67 @@
+// KatanaReaderNX – start-up timeline
+// See startup.h.
+
+#include "startup.h"
+#include "platform.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+static const int MAX_PHASES = 16;
+
+struct StartupPhase {
+  const char *name;
+  uint64_t endNs; // since startupBegin
+};
+
+static uint64_t startNs = 0;
+static StartupPhase phases[MAX_PHASES];
+static int phaseCount = 0;
+static std::mutex phaseMtx; // phases end on the main and start-up threads
+static uint64_t firstPageNs = 0;
+static int budgetMs = -1;
+
+void startupBegin() { startNs = platformNowNs(); }
+
+void startupMark(const char *phase) {
+  TRACE_INSTANT(phase);
+  uint64_t endNs = platformNowNs() - startNs;
+  std::lock_guard<std::mutex> lock(phaseMtx);
+  if (phaseCount < MAX_PHASES)
+    phases[phaseCount++] = {phase, endNs};
+}
+
+void startupFirstPage() {
+  if (firstPageNs == 0)
+    firstPageNs = platformNowNs() - startNs;
+}
+
+uint64_t startupTtfpNs() { return firstPageNs; }
+
+void startupSetBudget(int ms) { budgetMs = ms; }
+
+bool startupReport() {
+  std::lock_guard<std::mutex> lock(phaseMtx);
+  std::sort(phases, phases + phaseCount,
+            [](const StartupPhase &a, const StartupPhase &b) {
+              return a.endNs < b.endNs;
+            });
+  uint64_t prev = 0;
+  for (int i = 0; i < phaseCount; i++) {
+    printf("[startup] %-18s %8.1f ms  (+%.1f ms)\n", phases[i].name,
+           phases[i].endNs / 1e6, (phases[i].endNs - prev) / 1e6);
+    prev = phases[i].endNs;
+  }
+  if (firstPageNs)
+    printf("[startup] %-18s %8.1f ms\n", "first page", firstPageNs / 1e6);
+  else
+    printf("[startup] no page was shown\n");
+
+  if (budgetMs < 0)
+    return true;
+  bool ok = firstPageNs && firstPageNs <= (uint64_t)budgetMs * 1000000ull;
+  printf("[startup] time-to-first-page budget %d ms: %s\n", budgetMs,
+         ok ? "met" : "MISSED");
+  return ok;
+}
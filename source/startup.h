@@ -0,0 +1,28 @@
+// KatanaReaderNX – start-up timeline
+// Timestamps each start-up phase and the first frame that shows a page
+// (time-to-first-page, TTFP), all relative to the top of main(). The phases
+// are printed on exit and, in KATANA_TRACE builds, also appear as instant
+// events on the trace timeline.
+
+#pragma once
+#include <cstdint>
+
+// First thing in main()
+void startupBegin();
+
+// A phase just ended; callable from any thread. Names must be string
+// literals. Phases are reported in the order they ended.
+void startupMark(const char *phase);
+
+// A frame showing a page was presented; only the first call counts.
+void startupFirstPage();
+
+// Nanoseconds from startupBegin to the first page, 0 if none was shown yet.
+uint64_t startupTtfpNs();
+
+// Fail the run when TTFP exceeds `ms`, or no page is ever shown (host
+// --ttfp-budget).
+void startupSetBudget(int ms);
+
+// Print the timeline. Returns false if a budget was set and missed.
+bool startupReport();
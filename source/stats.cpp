@@ -0,0 +1,77 @@
+// KatanaReaderNX – runtime performance counters
+// See stats.h.
+
+#include "stats.h"
+#include "platform.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+static const int FRAME_HISTORY = 256; // recent frames kept for percentiles
+static const float EMA_WEIGHT = 0.25f; // weight of the newest sample
+
+static uint64_t frameEnd[FRAME_HISTORY];
+static uint64_t frameCost[FRAME_HISTORY];
+static int frameCount = 0; // total frames recorded, main thread only
+
+static std::mutex loaderMtx; // decode and download come from the cache worker
+static float decodeMsAvg = 0.0f;
+static float netKBpsAvg = 0.0f;
+
+static std::atomic<uint32_t> pageHits{0};
+static std::atomic<uint32_t> pageMisses{0};
+
+void statsFrame(uint64_t endNs, uint64_t costNs) {
+  frameEnd[frameCount % FRAME_HISTORY] = endNs;
+  frameCost[frameCount % FRAME_HISTORY] = costNs;
+  frameCount++;
+}
+
+static float ema(float avg, float sample) {
+  return avg == 0.0f ? sample : avg + (sample - avg) * EMA_WEIGHT;
+}
+
+void statsDecode(uint64_t ns) {
+  std::lock_guard<std::mutex> lock(loaderMtx);
+  decodeMsAvg = ema(decodeMsAvg, ns / 1e6f);
+}
+
+void statsDownload(size_t bytes, uint64_t ns) {
+  if (ns == 0)
+    return;
+  std::lock_guard<std::mutex> lock(loaderMtx);
+  netKBpsAvg = ema(netKBpsAvg, bytes / 1024.0f / (ns / 1e9f));
+}
+
+void statsPageVisit(bool hit) {
+  (hit ? pageHits : pageMisses).fetch_add(1, std::memory_order_relaxed);
+}
+
+StatsSnapshot statsSnapshot(uint64_t nowNs) {
+  StatsSnapshot s = {};
+  int n = std::min(frameCount, FRAME_HISTORY);
+
+  uint64_t costs[FRAME_HISTORY];
+  for (int i = 0; i < n; i++) {
+    if (nowNs - frameEnd[i] < 1000000000ull)
+      s.fps += 1.0f;
+    costs[i] = frameCost[i];
+  }
+  if (n > 0) {
+    std::nth_element(costs, costs + n / 2, costs + n);
+    s.frameP50Ms = costs[n / 2] / 1e6f;
+    int p99 = std::min(n - 1, n * 99 / 100);
+    std::nth_element(costs, costs + p99, costs + n);
+    s.frameP99Ms = costs[p99] / 1e6f;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(loaderMtx);
+    s.decodeMs = decodeMsAvg;
+    s.netKBps = netKBpsAvg;
+  }
+  uint32_t hits = pageHits.load(), misses = pageMisses.load();
+  s.cacheHitRate = hits + misses ? (float)hits / (hits + misses) : 0.0f;
+  s.memUsed = platformMemoryUsed();
+  return s;
+}
@@ -0,0 +1,27 @@
+// KatanaReaderNX – runtime performance counters
+// Cheap counters fed by the render loop and the page loader, summarised for
+// the on-screen HUD. Recording is thread-safe; statsSnapshot is meant for the
+// main thread.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// One produced frame: its end time and how long it took to render.
+void statsFrame(uint64_t endNs, uint64_t costNs);
+void statsDecode(uint64_t ns);
+void statsDownload(size_t bytes, uint64_t ns);
+// The reader arrived at a page; `hit` if it was already decoded in RAM.
+void statsPageVisit(bool hit);
+
+struct StatsSnapshot {
+  float fps;        // frames produced during the last second
+  float frameP50Ms; // render cost percentiles over the recent frames
+  float frameP99Ms;
+  float decodeMs;   // moving average
+  float netKBps;    // moving average of download throughput
+  float cacheHitRate;
+  uint64_t memUsed; // bytes handed out by malloc (platformMemoryUsed)
+};
+
+StatsSnapshot statsSnapshot(uint64_t nowNs);
@@ -0,0 +1,162 @@
+// KatanaReaderNX – in-frame text
+// See text.h.
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imstb_truetype.h"
+#include "text.h"
+#include "platform.h"
+#include <vector>
+
+static const float FONT_PX = 20.0f;
+static const int FIRST_CHAR = 32; // printable ASCII
+static const int LAST_CHAR = 126;
+static const int GLYPH_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+static const int ATLAS_MIN = 128; // atlas side, doubled until everything fits
+static const int ATLAS_MAX = 1024;
+
+struct AtlasGlyph {
+  int x, y, w, h;    // coverage rectangle in the atlas
+  int xoff, yoff;    // offset from the pen position (yoff from the baseline)
+  int advance;
+};
+
+struct TextAtlas {
+  bool ready = false;
+  int size = 0;
+  int ascent = 0, lineHeight = 0;
+  std::vector<uint8_t> coverage; // size × size, one byte per pixel
+  AtlasGlyph glyphs[GLYPH_COUNT];
+};
+
+static TextAtlas atlas;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Atlas
+// ─────────────────────────────────────────────────────────────────────────────
+bool textInit() {
+  size_t size;
+  const uint8_t *data = platformFontData(size);
+  stbtt_fontinfo font;
+  if (!data ||
+      !stbtt_InitFont(&font, data, stbtt_GetFontOffsetForIndex(data, 0)))
+    return false;
+
+  float scale = stbtt_ScaleForPixelHeight(&font, FONT_PX);
+  int ascent, descent, lineGap;
+  stbtt_GetFontVMetrics(&font, &ascent, &descent, &lineGap);
+  atlas.ascent = (int)(ascent * scale + 0.5f);
+  atlas.lineHeight = (int)((ascent - descent + lineGap) * scale + 0.5f);
+
+  // Measure every glyph, then pack them with a pixel of padding each.
+  stbrp_rect rects[GLYPH_COUNT];
+  for (int i = 0; i < GLYPH_COUNT; i++) {
+    AtlasGlyph &g = atlas.glyphs[i];
+    int adv, lsb, x0, y0, x1, y1;
+    stbtt_GetCodepointHMetrics(&font, FIRST_CHAR + i, &adv, &lsb);
+    stbtt_GetCodepointBitmapBox(&font, FIRST_CHAR + i, scale, scale, &x0, &y0,
+                                &x1, &y1);
+    g.w = x1 - x0;
+    g.h = y1 - y0;
+    g.xoff = x0;
+    g.yoff = y0;
+    g.advance = (int)(adv * scale + 0.5f);
+    rects[i] = {i, g.w + 1, g.h + 1, 0, 0, 0};
+  }
+
+  int side = ATLAS_MIN;
+  for (;; side *= 2) {
+    if (side > ATLAS_MAX)
+      return false;
+    std::vector<stbrp_node> nodes(side);
+    stbrp_context ctx;
+    stbrp_init_target(&ctx, side, side, nodes.data(), side);
+    if (stbrp_pack_rects(&ctx, rects, GLYPH_COUNT))
+      break;
+  }
+
+  atlas.size = side;
+  atlas.coverage.assign((size_t)side * side, 0);
+  for (int i = 0; i < GLYPH_COUNT; i++) {
+    AtlasGlyph &g = atlas.glyphs[i];
+    g.x = rects[i].x;
+    g.y = rects[i].y;
+    if (g.w > 0 && g.h > 0)
+      stbtt_MakeCodepointBitmap(&font, &atlas.coverage[g.y * side + g.x], g.w,
+                                g.h, side, scale, scale, FIRST_CHAR + i);
+  }
+  atlas.ready = true;
+  return true;
+}
+
+void textExit() {
+  atlas.ready = false;
+  atlas.coverage.clear();
+  atlas.coverage.shrink_to_fit();
+}
+
+bool textReady() { return atlas.ready; }
+
+int textLineHeight() { return atlas.lineHeight; }
+
+static const AtlasGlyph &glyphFor(char c) {
+  int i = (unsigned char)c - FIRST_CHAR;
+  if (i < 0 || i >= GLYPH_COUNT)
+    i = '?' - FIRST_CHAR;
+  return atlas.glyphs[i];
+}
+
+int textWidth(const char *s) {
+  if (!atlas.ready)
+    return 0;
+  int w = 0;
+  for (; *s; s++)
+    w += glyphFor(*s).advance;
+  return w;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Drawing
+// ─────────────────────────────────────────────────────────────────────────────
+static inline uint32_t blend(uint32_t dst, uint32_t src, uint32_t a) {
+  uint32_t inv = 255 - a;
+  uint32_t r = ((src & 0xff) * a + (dst & 0xff) * inv) / 255;
+  uint32_t g = (((src >> 8) & 0xff) * a + ((dst >> 8) & 0xff) * inv) / 255;
+  uint32_t b = (((src >> 16) & 0xff) * a + ((dst >> 16) & 0xff) * inv) / 255;
+  return rgba8(r, g, b, 0xff);
+}
+
+int textDraw(uint32_t *fb, int u, int v, const char *s, uint32_t colour,
+             const Rect &clip) {
+  if (!atlas.ready)
+    return 0;
+  int start = u;
+  int baseline = v + atlas.ascent;
+  for (; *s; s++) {
+    const AtlasGlyph &g = glyphFor(*s);
+    // Glyph rows run along portrait v (screen columns, right to left) and
+    // glyph columns along portrait u (screen rows).
+    for (int gy = 0; gy < g.h; gy++) {
+      int sx = SCREEN_W - 1 - (baseline + g.yoff + gy);
+      if (sx < clip.x0 || sx >= clip.x1)
+        continue;
+      const uint8_t *cov = &atlas.coverage[(g.y + gy) * atlas.size + g.x];
+      for (int gx = 0; gx < g.w; gx++) {
+        int sy = u + g.xoff + gx;
+        if (cov[gx] && sy >= clip.y0 && sy < clip.y1) {
+          uint32_t &px = fb[sy * SCREEN_W + sx];
+          px = blend(px, colour, cov[gx]);
+        }
+      }
+    }
+    u += g.advance;
+  }
+  return u - start;
+}
+
+void shadeRect(uint32_t *fb, const Rect &r, uint32_t colour, uint32_t alpha) {
+  for (int y = r.y0; y < r.y1; y++)
+    for (int x = r.x0; x < r.x1; x++)
+      fb[y * SCREEN_W + x] = blend(fb[y * SCREEN_W + x], colour, alpha);
+}
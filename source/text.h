@@ -0,0 +1,39 @@
+// KatanaReaderNX – in-frame text
+// Glyphs are rasterised once with stb_truetype, packed into an 8-bit coverage
+// atlas with stb_rect_pack and alpha-blended straight into the framebuffer, so
+// status messages, progress and the HUD all draw without leaving it.
+//
+// Text is laid out in portrait coordinates, the way the user holds the
+// console: u runs left→right across the 720px width, v runs top→bottom along
+// the 1280px height. The framebuffer is rotated 90° clockwise, so (u, v) lands
+// on framebuffer pixel (SCREEN_W-1-v, u).
+
+#pragma once
+#include "render.h"
+#include <cstdint>
+
+static const int PORTRAIT_W = SCREEN_H;
+static const int PORTRAIT_H = SCREEN_W;
+
+// Framebuffer rectangle covering the portrait rectangle [u0,u1) × [v0,v1).
+inline Rect portraitRect(int u0, int v0, int u1, int v1) {
+  return {SCREEN_W - v1, u0, SCREEN_W - v0, u1};
+}
+
+// Build the atlas from the platform font. Returns false (and text drawing
+// does nothing) when no font is available.
+bool textInit();
+void textExit();
+bool textReady();
+
+int textLineHeight();
+int textWidth(const char *s);
+
+// Draw `s` with its top-left corner at portrait (u, v), touching only pixels
+// inside `clip`. Characters outside printable ASCII draw as '?'. Returns the
+// advance in pixels.
+int textDraw(uint32_t *fb, int u, int v, const char *s, uint32_t colour,
+             const Rect &clip = FULL_SCREEN);
+
+// Blend `colour` over `r` with the given opacity (0–255).
+void shadeRect(uint32_t *fb, const Rect &r, uint32_t colour, uint32_t alpha);
@@ -0,0 +1,107 @@
+// KatanaReaderNX – timeline tracing
+// See trace.h.
+
+#ifdef KATANA_TRACE
+#include "trace.h"
+#include "nlohmann/json.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#ifdef __SWITCH__
+#include <switch.h>
+#endif
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Ring buffer
+// Writers claim a slot with one fetch_add and publish it by storing the slot's
+// sequence number last; the oldest events are overwritten when it wraps. The
+// dumper only keeps slots whose sequence is unchanged across its copy.
+// ─────────────────────────────────────────────────────────────────────────────
+static const uint32_t TRACE_CAPACITY = 1 << 15; // must be a power of two
+
+struct TraceEvent {
+  std::atomic<uint64_t> seq{0}; // claim index + 1 once written, 0 = empty
+  const char *name;
+  uint64_t startNs;
+  uint64_t durNs; // ~0 for instant events
+  uint32_t tid;
+};
+
+static TraceEvent ring[TRACE_CAPACITY];
+static std::atomic<uint64_t> head{0};
+static std::atomic<uint32_t> nextTid{1};
+
+static uint64_t traceNowNs() {
+#ifdef __SWITCH__
+  return armTicksToNs(armGetSystemTick());
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+static uint32_t traceTid() {
+  thread_local uint32_t tid = nextTid.fetch_add(1, std::memory_order_relaxed);
+  return tid;
+}
+
+static void traceRecord(const char *name, uint64_t startNs, uint64_t durNs) {
+  uint64_t idx = head.fetch_add(1, std::memory_order_relaxed);
+  TraceEvent &e = ring[idx & (TRACE_CAPACITY - 1)];
+  e.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  e.name = name;
+  e.startNs = startNs;
+  e.durNs = durNs;
+  e.tid = traceTid();
+  e.seq.store(idx + 1, std::memory_order_release);
+}
+
+TraceScope::TraceScope(const char *name) : name(name), startNs(traceNowNs()) {}
+
+TraceScope::~TraceScope() {
+  traceRecord(name, startNs, traceNowNs() - startNs);
+}
+
+void traceInstant(const char *name) { traceRecord(name, traceNowNs(), ~0ull); }
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Chrome trace_event export
+// ─────────────────────────────────────────────────────────────────────────────
+bool traceDump(const char *path) {
+  uint64_t end = head.load(std::memory_order_acquire);
+  uint64_t begin = end > TRACE_CAPACITY ? end - TRACE_CAPACITY : 0;
+
+  nlohmann::json events = nlohmann::json::array();
+  for (uint64_t idx = begin; idx < end; idx++) {
+    TraceEvent &e = ring[idx & (TRACE_CAPACITY - 1)];
+    if (e.seq.load(std::memory_order_acquire) != idx + 1)
+      continue;
+    const char *name = e.name;
+    uint64_t startNs = e.startNs, durNs = e.durNs;
+    uint32_t tid = e.tid;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (e.seq.load(std::memory_order_relaxed) != idx + 1)
+      continue; // overwritten while we were copying it
+
+    nlohmann::json ev = {{"name", name},
+                         {"pid", 1},
+                         {"tid", tid},
+                         {"ts", startNs / 1000.0}};
+    if (durNs == ~0ull) {
+      ev["ph"] = "i";
+      ev["s"] = "t";
+    } else {
+      ev["ph"] = "X";
+      ev["dur"] = durNs / 1000.0;
+    }
+    events.push_back(std::move(ev));
+  }
+
+  std::ofstream out(path);
+  out << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}
+             .dump();
+  return (bool)out;
+}
+#endif
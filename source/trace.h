@@ -0,0 +1,41 @@
+// KatanaReaderNX – timeline tracing
+// TRACE_SCOPE("name") records how long the enclosing scope took into a
+// lock-free ring buffer; traceDump writes the buffer as Chrome trace_event
+// JSON, viewable in chrome://tracing or Perfetto.
+//
+// Tracing only exists in builds made with KATANA_TRACE defined
+// (make TRACE=1). Otherwise the macros expand to nothing and none of this is
+// compiled in.
+
+#pragma once
+#include <cstdint>
+
+#ifdef KATANA_TRACE
+
+struct TraceScope {
+  explicit TraceScope(const char *name);
+  ~TraceScope();
+  const char *name;
+  uint64_t startNs;
+};
+
+// Names must be string literals (or otherwise outlive the dump).
+void traceInstant(const char *name);
+
+// Write all buffered events to `path`. Safe to call while other threads are
+// still recording; events being written at that moment are skipped.
+bool traceDump(const char *path);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_INSTANT(name) traceInstant(name)
+#define TRACE_DUMP(path) traceDump(path)
+
+#else
+
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_INSTANT(name) ((void)0)
+#define TRACE_DUMP(path) ((void)0)
+
+#endif
@@ -0,0 +1,208 @@
+// KatanaReaderNX – write-behind disk writer
+// See writer.h.
+
+#include "writer.h"
+#include "platform.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+static const size_t QUEUE_LIMIT = 24u << 20; // bytes waiting to be written
+
+struct WriteJob {
+  std::string path;
+  std::vector<uint8_t> data; // file contents
+  std::string line;          // or an index line to append
+  bool append;
+  WritePriority prio;
+};
+
+struct Writer {
+  std::mutex mtx;
+  std::condition_variable cv;   // work queued or quit
+  std::condition_variable room; // a batch finished
+  std::deque<WriteJob> queue;
+  size_t queued = 0; // bytes queued or being written
+  bool running = false, quit = false, sync = false;
+  std::atomic<bool> lowMemory{false};
+  std::thread thread;
+
+  std::atomic<uint64_t> files{0}, bytes{0}, dropped{0};
+  size_t peak = 0;
+  uint64_t worstBatchNs = 0;
+};
+
+static Writer writer;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Disk
+// ─────────────────────────────────────────────────────────────────────────────
+// Write-then-rename so a crash mid-write never leaves a torn file
+static void writeFile(const std::string &path,
+                      const std::vector<uint8_t> &data) {
+  FILE *f = fopen((path + ".tmp").c_str(), "wb");
+  if (!f)
+    return;
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  ok &= fclose(f) == 0;
+  if (ok)
+    rename((path + ".tmp").c_str(), path.c_str());
+  else
+    remove((path + ".tmp").c_str());
+  writer.files++;
+  writer.bytes += data.size();
+}
+
+static void appendText(const std::string &path, const std::string &text) {
+  if (FILE *f = fopen(path.c_str(), "a")) {
+    fwrite(text.data(), 1, text.size(), f);
+    fclose(f);
+  }
+  writer.bytes += text.size();
+}
+
+static void writeBatch(std::deque<WriteJob> &batch) {
+  TRACE_SCOPE("writeBatch");
+  for (const WriteJob &job : batch)
+    if (!job.append)
+      writeFile(job.path, job.data);
+
+  // Index lines last, one append per index file, in queue order
+  std::vector<std::pair<std::string, std::string>> indexes;
+  for (WriteJob &job : batch) {
+    if (!job.append)
+      continue;
+    auto it = std::find_if(indexes.begin(), indexes.end(),
+                           [&](const auto &i) { return i.first == job.path; });
+    if (it == indexes.end())
+      indexes.push_back({job.path, std::move(job.line)});
+    else
+      it->second += job.line;
+  }
+  for (const auto &i : indexes)
+    appendText(i.first, i.second);
+}
+
+static void writerThread() {
+  std::unique_lock<std::mutex> lock(writer.mtx);
+  for (;;) {
+    writer.cv.wait(lock, [] { return writer.quit || !writer.queue.empty(); });
+    if (writer.queue.empty())
+      break; // quit with nothing left to write
+    std::deque<WriteJob> batch;
+    batch.swap(writer.queue);
+    size_t size = 0;
+    for (const WriteJob &job : batch)
+      size += job.data.size() + job.line.size();
+    lock.unlock();
+
+    uint64_t start = platformNowNs();
+    writeBatch(batch);
+    uint64_t ns = platformNowNs() - start;
+
+    lock.lock();
+    writer.queued -= size;
+    writer.worstBatchNs = std::max(writer.worstBatchNs, ns);
+    writer.room.notify_all();
+  }
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Queue
+// ─────────────────────────────────────────────────────────────────────────────
+void writerStart() {
+  if (writer.running || writer.sync)
+    return;
+  writer.quit = false;
+  writer.running = true;
+  writer.thread = std::thread(writerThread);
+}
+
+void writerStop() {
+  if (writer.running) {
+    {
+      std::lock_guard<std::mutex> lock(writer.mtx);
+      writer.quit = true;
+    }
+    writer.cv.notify_one();
+    writer.thread.join();
+    writer.running = false;
+  }
+  if (writer.files || writer.dropped)
+    printf("[writer] %llu files, %.1f MB, %llu dropped, queue peak %.1f MB, "
+           "worst batch %.1f ms%s\n",
+           (unsigned long long)writer.files.load(), writer.bytes / 1048576.0,
+           (unsigned long long)writer.dropped.load(), writer.peak / 1048576.0,
+           writer.worstBatchNs / 1e6, writer.sync ? " (sync)" : "");
+}
+
+void writerSetSync(bool sync) { writer.sync = sync; }
+
+// Drop queued low-priority writes, oldest first, until no more than `keep`
+// bytes are queued. Called with the lock held.
+static void dropLow(size_t keep) {
+  for (auto it = writer.queue.begin();
+       writer.queued > keep && it != writer.queue.end();) {
+    if (it->prio == WRITE_LOW) {
+      writer.queued -= it->data.size();
+      writer.dropped++;
+      it = writer.queue.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void writerSetLowMemory(bool low) {
+  if (writer.lowMemory.exchange(low) || !low)
+    return;
+  std::lock_guard<std::mutex> lock(writer.mtx);
+  dropLow(0);
+}
+
+static void submit(WriteJob &&job) {
+  if (!writer.running) {
+    if (job.append)
+      appendText(job.path, job.line);
+    else
+      writeFile(job.path, job.data);
+    return;
+  }
+
+  if (job.prio == WRITE_LOW && writer.lowMemory) {
+    writer.dropped++;
+    return;
+  }
+  size_t size = job.data.size() + job.line.size();
+  std::unique_lock<std::mutex> lock(writer.mtx);
+  // Over the limit: make room from the low-priority writes
+  dropLow(size < QUEUE_LIMIT ? QUEUE_LIMIT - size : 0);
+  if (writer.queued + size > QUEUE_LIMIT) {
+    if (job.prio == WRITE_LOW) {
+      writer.dropped++;
+      return;
+    }
+    writer.room.wait(lock, [&] {
+      return writer.queued == 0 || writer.queued + size <= QUEUE_LIMIT;
+    });
+  }
+  writer.queued += size;
+  writer.peak = std::max(writer.peak, writer.queued);
+  writer.queue.push_back(std::move(job));
+  writer.cv.notify_one();
+}
+
+void writerFile(const std::string &path, std::vector<uint8_t> data,
+                WritePriority prio) {
+  submit({path, std::move(data), std::string(), false, prio});
+}
+
+void writerAppend(const std::string &path, std::string line) {
+  submit({path, {}, std::move(line), true, WRITE_HIGH});
+}
@@ -0,0 +1,42 @@
+// KatanaReaderNX – write-behind disk writer
+// SD card writes can take tens of milliseconds and stall whoever makes them,
+// so every file the reader keeps (saved pages, snapshots, recorded sessions,
+// the resume state) is handed to one writer thread instead.
+//
+// - The queue is bounded by bytes. When it is full, queued low-priority
+//   writes are dropped to make room, then the new write itself if it is low
+//   priority; a high-priority write waits for room instead. While memory is
+//   tight (writerSetLowMemory) low-priority writes aren't queued at all.
+// - The thread takes everything queued at once and writes it as a batch:
+//   data files first (write-then-rename), then index lines, with all lines
+//   for the same index file appended in one go. An index line therefore
+//   never reaches the disk before a file queued ahead of it.
+//
+// With write-behind off (host --sync-writes) every call writes straight
+// away on the calling thread, for comparing frame times.
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum WritePriority {
+  WRITE_LOW,  // can be recreated (snapshots): dropped when the queue is full
+  WRITE_HIGH, // needed later (saved pages, state, sessions): never dropped
+};
+
+void writerStart();
+// Write everything still queued, then stop the thread.
+void writerStop();
+
+void writerSetSync(bool sync);
+
+// Drop low-priority writes, queued and new, instead of holding their data
+// in memory until the disk catches up.
+void writerSetLowMemory(bool low);
+
+// Replace `path` with `data`.
+void writerFile(const std::string &path, std::vector<uint8_t> data,
+                WritePriority prio);
+// Append `line` to the index file `path`, after every file queued before it.
+void writerAppend(const std::string &path, std::string line);
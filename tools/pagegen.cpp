@@ -0,0 +1,298 @@
+// KatanaReaderNX – synthetic manga page generator
+// Writes pages with the statistics of real chapters, so decode, scale and
+// cache benchmarks measure something close to production data without
+// committing copyrighted scans:
+//
+//   make -f Makefile.host pages     fills bench/pages with the defaults
+//   build_host/pagegen [--out DIR] [--count N] [--seed S]
+//                      [--width W] [--height H] [--format jpg|png|webp|mix]
+//                      [--quality Q] [--colour P] [--strips N]
+//                      [--strip-height H]
+//
+// Pages are mostly grayscale line art on white, with wide margins, panel
+// borders, speech bubbles and screen tone; a fraction P of them (--colour)
+// are colour pages. --strips adds very tall webtoon-style colour strips.
+// "mix" writes mostly JPEG with every fourth page as PNG. WebP needs a build
+// with WEBP=1 (libwebp); without it WebP pages are written as JPEG.
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#ifdef HAVE_WEBP
+#include <webp/encode.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+struct Options {
+  std::string out = "bench/pages";
+  int count = 12;
+  unsigned seed = 1;
+  int width = 800, height = 1200;
+  std::string format = "mix";
+  int quality = 85;
+  double colour = 0.1;
+  int strips = 2;
+  int stripHeight = 9000;
+};
+
+static Options opt;
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Canvas – RGB8, white to start with
+// ─────────────────────────────────────────────────────────────────────────────
+struct Canvas {
+  int w, h;
+  std::vector<uint8_t> rgb;
+  Canvas(int w, int h) : w(w), h(h), rgb((size_t)w * h * 3, 0xff) {}
+
+  void set(int x, int y, uint8_t r, uint8_t g, uint8_t b) {
+    if (x < 0 || y < 0 || x >= w || y >= h)
+      return;
+    uint8_t *p = &rgb[((size_t)y * w + x) * 3];
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+  }
+  void grey(int x, int y, uint8_t v) { set(x, y, v, v, v); }
+};
+
+struct Box {
+  int x0, y0, x1, y1;
+};
+
+using Rng = std::mt19937;
+
+static int randInt(Rng &rng, int lo, int hi) {
+  return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+static double randReal(Rng &rng, double lo, double hi) {
+  return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Drawing primitives
+// ─────────────────────────────────────────────────────────────────────────────
+static void fillBox(Canvas &c, const Box &b, uint8_t r, uint8_t g, uint8_t bl) {
+  for (int y = std::max(b.y0, 0); y < std::min(b.y1, c.h); y++)
+    for (int x = std::max(b.x0, 0); x < std::min(b.x1, c.w); x++)
+      c.set(x, y, r, g, bl);
+}
+
+static void frameBox(Canvas &c, const Box &b, int t) {
+  fillBox(c, {b.x0, b.y0, b.x1, b.y0 + t}, 0, 0, 0);
+  fillBox(c, {b.x0, b.y1 - t, b.x1, b.y1}, 0, 0, 0);
+  fillBox(c, {b.x0, b.y0, b.x0 + t, b.y1}, 0, 0, 0);
+  fillBox(c, {b.x1 - t, b.y0, b.x1, b.y1}, 0, 0, 0);
+}
+
+static void disc(Canvas &c, double cx, double cy, double r, uint8_t v,
+                 const Box &clip) {
+  for (int y = (int)(cy - r); y <= (int)(cy + r); y++)
+    for (int x = (int)(cx - r); x <= (int)(cx + r); x++)
+      if (x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1 &&
+          (x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+        c.grey(x, y, v);
+}
+
+// Ink stroke along a quadratic Bézier, clipped to the panel
+static void stroke(Canvas &c, Rng &rng, const Box &p, double width) {
+  double x0 = randReal(rng, p.x0, p.x1), y0 = randReal(rng, p.y0, p.y1);
+  double x1 = randReal(rng, p.x0, p.x1), y1 = randReal(rng, p.y0, p.y1);
+  double x2 = randReal(rng, p.x0, p.x1), y2 = randReal(rng, p.y0, p.y1);
+  double len = std::hypot(x1 - x0, y1 - y0) + std::hypot(x2 - x1, y2 - y1);
+  int steps = std::max(2, (int)len);
+  for (int i = 0; i <= steps; i++) {
+    double t = (double)i / steps, u = 1 - t;
+    double x = u * u * x0 + 2 * u * t * x1 + t * t * x2;
+    double y = u * u * y0 + 2 * u * t * y1 + t * t * y2;
+    disc(c, x, y, width * (0.4 + 0.6 * std::sin(t * M_PI)), 0, p);
+  }
+}
+
+// Screen tone: a halftone dot grid whose dot size ramps across the region
+static void screenTone(Canvas &c, Rng &rng, const Box &r) {
+  int period = randInt(rng, 5, 8);
+  double maxR = period * randReal(rng, 0.3, 0.55);
+  bool vertical = randInt(rng, 0, 1);
+  for (int y = r.y0 + period / 2; y < r.y1; y += period)
+    for (int x = r.x0 + period / 2; x < r.x1; x += period) {
+      double t = vertical ? (double)(y - r.y0) / (r.y1 - r.y0)
+                          : (double)(x - r.x0) / (r.x1 - r.x0);
+      disc(c, x, y, maxR * t, 40, r);
+    }
+}
+
+// Speech bubble: white ellipse with an ink outline and a few "text" lines
+static void bubble(Canvas &c, Rng &rng, const Box &p) {
+  double rx = randReal(rng, 40, 90), ry = randReal(rng, 50, 110);
+  if (p.x1 - p.x0 < rx * 2 + 8 || p.y1 - p.y0 < ry * 2 + 8)
+    return;
+  double cx = randReal(rng, p.x0 + rx + 4, p.x1 - rx - 4);
+  double cy = randReal(rng, p.y0 + ry + 4, p.y1 - ry - 4);
+  for (int y = (int)(cy - ry) - 3; y <= (int)(cy + ry) + 3; y++)
+    for (int x = (int)(cx - rx) - 3; x <= (int)(cx + rx) + 3; x++) {
+      double d = std::hypot((x - cx) / rx, (y - cy) / ry);
+      if (d <= 1.0)
+        c.grey(x, y, 0xff);
+      else if (d <= 1.0 + 3.0 / std::min(rx, ry))
+        c.grey(x, y, 0);
+    }
+  for (double y = cy - ry * 0.5; y < cy + ry * 0.5; y += 14)
+    fillBox(c, {(int)(cx - rx * 0.6), (int)y, (int)(cx + rx * 0.6), (int)y + 6},
+            30, 30, 30);
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Panels and pages
+// ─────────────────────────────────────────────────────────────────────────────
+static void drawPanel(Canvas &c, Rng &rng, const Box &p, bool colour) {
+  if (colour) {
+    // Flat colour background with a vertical shade, like digital colouring
+    uint8_t r = randInt(rng, 80, 250), g = randInt(rng, 80, 250),
+            b = randInt(rng, 80, 250);
+    for (int y = p.y0; y < p.y1; y++) {
+      double shade = 0.75 + 0.25 * (double)(y - p.y0) / (p.y1 - p.y0);
+      fillBox(c, {p.x0, y, p.x1, y + 1}, r * shade, g * shade, b * shade);
+    }
+  } else if (randInt(rng, 0, 2) == 0) {
+    Box tone = {randInt(rng, p.x0, (p.x0 + p.x1) / 2), p.y0, p.x1,
+                randInt(rng, (p.y0 + p.y1) / 2, p.y1)};
+    screenTone(c, rng, tone);
+  }
+
+  int strokes = randInt(rng, 6, 20);
+  for (int i = 0; i < strokes; i++)
+    stroke(c, rng, p, randReal(rng, 1.0, 3.5));
+  if (randInt(rng, 0, 3) == 0) // a solid black area (hair, shadow)
+    disc(c, randReal(rng, p.x0, p.x1), randReal(rng, p.y0, p.y1),
+         randReal(rng, 15, 50), 0, p);
+  if (randInt(rng, 0, 1) == 0)
+    bubble(c, rng, p);
+  frameBox(c, p, 3);
+}
+
+// Classic page: wide white margins, 2–4 rows of 1–3 panels
+static Canvas makePage(Rng &rng, int w, int h, bool colour) {
+  Canvas c(w, h);
+  const int gutter = 14;
+  int mx = w * randInt(rng, 6, 10) / 100, my = h * randInt(rng, 5, 8) / 100;
+  int rows = randInt(rng, 2, 4);
+  int y = my;
+  for (int r = 0; r < rows; r++) {
+    int rowH = (h - 2 * my - gutter * (rows - 1)) / rows;
+    int cols = randInt(rng, 1, 3);
+    int x = mx;
+    for (int col = 0; col < cols; col++) {
+      int colW = col == cols - 1 ? w - mx - x
+                                 : (w - 2 * mx - gutter * (cols - 1)) / cols +
+                                       randInt(rng, -30, 30);
+      drawPanel(c, rng, {x, y, x + colW, y + rowH}, colour);
+      x += colW + gutter;
+    }
+    y += rowH + gutter;
+  }
+  return c;
+}
+
+// Webtoon strip: full-width colour panels with long white gaps between them
+static Canvas makeStrip(Rng &rng, int w, int h) {
+  Canvas c(w, h);
+  int y = randInt(rng, 100, 400);
+  while (y < h - 300) {
+    int panelH = std::min(randInt(rng, 500, 1400), h - y);
+    int inset = randInt(rng, 0, 1) ? 0 : w / 12;
+    drawPanel(c, rng, {inset, y, w - inset, y + panelH}, true);
+    y += panelH + randInt(rng, 200, 900);
+  }
+  return c;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Output
+// ─────────────────────────────────────────────────────────────────────────────
+static bool writePage(const Canvas &c, const std::string &base,
+                      std::string format) {
+#ifndef HAVE_WEBP
+  if (format == "webp")
+    format = "jpg";
+#endif
+  std::string path = base + "." + format;
+  bool ok = false;
+  if (format == "png") {
+    ok = stbi_write_png(path.c_str(), c.w, c.h, 3, c.rgb.data(), c.w * 3);
+#ifdef HAVE_WEBP
+  } else if (format == "webp") {
+    uint8_t *out = nullptr;
+    size_t size =
+        WebPEncodeRGB(c.rgb.data(), c.w, c.h, c.w * 3, opt.quality, &out);
+    if (FILE *f = size ? fopen(path.c_str(), "wb") : nullptr) {
+      ok = fwrite(out, 1, size, f) == size;
+      fclose(f);
+    }
+    WebPFree(out);
+#endif
+  } else {
+    ok = stbi_write_jpg(path.c_str(), c.w, c.h, 3, c.rgb.data(), opt.quality);
+  }
+  printf("%s %s (%dx%d)\n", ok ? "wrote" : "FAILED", path.c_str(), c.w, c.h);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--out") && hasValue)
+      opt.out = argv[++i];
+    else if (!strcmp(argv[i], "--count") && hasValue)
+      opt.count = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && hasValue)
+      opt.seed = (unsigned)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--width") && hasValue)
+      opt.width = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--height") && hasValue)
+      opt.height = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--format") && hasValue)
+      opt.format = argv[++i];
+    else if (!strcmp(argv[i], "--quality") && hasValue)
+      opt.quality = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--colour") && hasValue)
+      opt.colour = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--strips") && hasValue)
+      opt.strips = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--strip-height") && hasValue)
+      opt.stripHeight = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  mkdir(opt.out.c_str(), 0777);
+
+  Rng rng(opt.seed);
+  bool ok = true;
+  for (int i = 0; i < opt.count; i++) {
+    bool colour = randReal(rng, 0, 1) < opt.colour;
+    Canvas page = makePage(rng, opt.width, opt.height, colour);
+    std::string format = opt.format;
+    if (format == "mix")
+      format = i % 4 == 3 ? "png" : "jpg";
+    char base[64];
+    snprintf(base, sizeof(base), "/page-%03d%s", i + 1, colour ? "-colour" : "");
+    ok &= writePage(page, opt.out + base, format);
+  }
+  for (int i = 0; i < opt.strips; i++) {
+    Canvas strip = makeStrip(rng, opt.width, opt.stripHeight);
+    char base[64];
+    snprintf(base, sizeof(base), "/strip-%03d", i + 1);
+    ok &= writePage(strip, opt.out + base,
+                    opt.format == "mix" ? "jpg" : opt.format);
+  }
+  return ok ? 0 : 1;
+}
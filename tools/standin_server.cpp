@@ -0,0 +1,353 @@
+// KatanaReaderNX – local MangaKatana stand-in server
+// Serves a chapter over plain HTTP on 127.0.0.1 so the reader can be run and
+// measured without internet access:
+//
+//   make -f Makefile.host standin
+//   build_host/standin [--port 8080] [--pages N] [--pages-dir DIR]
+//                      [--session DIR] [--latency MS] [--kbps N]
+//                      [--stall-bytes N --stall-ms MS]
+//                      [--error-rate P] [--error-code 503] [--seed S]
+//   build_host/LightBrowser --base-url http://127.0.0.1:8080
+//
+// Content:
+//   --session DIR   answer with the responses of a recorded session (see
+//                   source/session.h); absolute URLs inside recorded HTML are
+//                   rewritten to point back at this server
+//   otherwise       a synthetic chapter page listing N pages (default 30),
+//                   served from the files in --pages-dir in turn or, without
+//                   one, as generated binary PPM images
+//
+// Network shaping, applied to every response:
+//   --latency MS    delay before the response starts
+//   --kbps N        bandwidth cap while sending the body
+//   --stall-bytes N --stall-ms MS
+//                   stop sending for MS after every N bytes, like a lost
+//                   packet waiting for retransmission
+//   --error-rate P  answer a fraction P (0–1) of requests with --error-code
+//
+// HTTPS is not emulated; the reader talks to the stand-in in plain HTTP.
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct Options {
+  int port = 8080;
+  int pages = 30;
+  std::string pagesDir;
+  std::string sessionDir;
+  int latencyMs = 0;
+  int kbps = 0;
+  size_t stallBytes = 0;
+  int stallMs = 0;
+  double errorRate = 0.0;
+  int errorCode = 503;
+  unsigned seed = 1;
+};
+
+static Options opt;
+static std::string origin; // http://127.0.0.1:PORT
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Content
+// ─────────────────────────────────────────────────────────────────────────────
+static const char *CHAPTER_PATH = "/manga/solo-leveling.16520/c200";
+
+static std::map<std::string, std::string> sessionFiles; // path -> body file
+static std::vector<std::string> sessionOrigins;          // scheme://host seen
+static std::vector<std::string> pageFiles;
+
+static std::string readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+static bool loadSession(const std::string &dir) {
+  FILE *f = fopen((dir + "/http/index.txt").c_str(), "r");
+  if (!f)
+    return false;
+  char line[4096], file[64];
+  size_t bytes;
+  int urlStart;
+  while (fgets(line, sizeof(line), f)) {
+    if (sscanf(line, "%63s %zu %n", file, &bytes, &urlStart) < 2)
+      continue;
+    std::string url = line + urlStart;
+    while (!url.empty() && (url.back() == '\n' || url.back() == '\r'))
+      url.pop_back();
+    size_t host = url.find("://");
+    size_t path = url.find('/', host == std::string::npos ? 0 : host + 3);
+    if (host == std::string::npos || path == std::string::npos)
+      continue;
+    std::string o = url.substr(0, path);
+    if (std::find(sessionOrigins.begin(), sessionOrigins.end(), o) ==
+        sessionOrigins.end())
+      sessionOrigins.push_back(o);
+    sessionFiles[url.substr(path)] = dir + "/http/" + file;
+  }
+  fclose(f);
+  return true;
+}
+
+static void loadPagesDir(const std::string &dir) {
+  if (DIR *d = opendir(dir.c_str())) {
+    while (dirent *e = readdir(d))
+      if (e->d_name[0] != '.')
+        pageFiles.push_back(dir + "/" + e->d_name);
+    closedir(d);
+  }
+  std::sort(pageFiles.begin(), pageFiles.end());
+}
+
+static std::string chapterHtml() {
+  std::string html = "<!DOCTYPE html><html><head><title>Solo Leveling "
+                     "Chapter 200</title></head><body>\n"
+                     "<script>var thumbs = ['" +
+                     origin + "/static/thumb.jpg'];\nvar ytaw=[";
+  for (int i = 0; i < opt.pages; i++) {
+    char url[64];
+    snprintf(url, sizeof(url), "/imgs/solo-leveling/c200/%03d.jpg", i + 1);
+    html += "'" + origin + url + "',";
+  }
+  html += "];\n</script></body></html>\n";
+  return html;
+}
+
+// A page-sized PPM with a few bands of grey so pages are told apart
+static std::string syntheticPage(int page) {
+  const int w = 800, h = 1200;
+  char header[32];
+  int n = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", w, h);
+  std::string body(header, n);
+  body.resize(n + (size_t)w * h * 3, (char)0xff);
+  for (int y = 0; y < h; y++) {
+    if ((y / 100 + page) % 3)
+      continue;
+    memset(&body[n + (size_t)y * w * 3], 0x30 + page * 17 % 0xa0, w * 3);
+  }
+  return body;
+}
+
+// Body for `path`, or false for a 404.
+static bool lookup(const std::string &path, std::string &body,
+                   std::string &type) {
+  if (!opt.sessionDir.empty()) {
+    auto it = sessionFiles.find(path);
+    if (it == sessionFiles.end())
+      return false;
+    body = readFile(it->second);
+    type = "application/octet-stream";
+    if (body.find("<html") != std::string::npos ||
+        body.find("<script") != std::string::npos) {
+      type = "text/html";
+      for (const std::string &o : sessionOrigins)
+        for (size_t p = 0; (p = body.find(o, p)) != std::string::npos;
+             p += origin.size())
+          body.replace(p, o.size(), origin);
+    }
+    return true;
+  }
+
+  if (path == CHAPTER_PATH) {
+    body = chapterHtml();
+    type = "text/html";
+    return true;
+  }
+  int page;
+  if (sscanf(path.c_str(), "/imgs/solo-leveling/c200/%d.jpg", &page) == 1 &&
+      page >= 1 && page <= opt.pages) {
+    if (!pageFiles.empty())
+      body = readFile(pageFiles[(page - 1) % pageFiles.size()]);
+    else
+      body = syntheticPage(page);
+    type = "image/jpeg";
+    return true;
+  }
+  return false;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Shaped sending
+// ─────────────────────────────────────────────────────────────────────────────
+static const size_t CHUNK = 4096;
+
+static bool sendAll(int fd, const char *p, size_t n) {
+  while (n > 0) {
+    ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+    if (w <= 0)
+      return false;
+    p += w;
+    n -= w;
+  }
+  return true;
+}
+
+static bool sendShaped(int fd, const std::string &data) {
+  using clock = std::chrono::steady_clock;
+  auto start = clock::now();
+  size_t sent = 0, sinceStall = 0;
+  while (sent < data.size()) {
+    size_t n = std::min(CHUNK, data.size() - sent);
+    if (opt.stallBytes)
+      n = std::min(n, opt.stallBytes - sinceStall);
+    if (!sendAll(fd, data.data() + sent, n))
+      return false;
+    sent += n;
+    sinceStall += n;
+
+    if (opt.stallBytes && sinceStall == opt.stallBytes) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(opt.stallMs));
+      sinceStall = 0;
+    }
+    if (opt.kbps > 0) {
+      auto due = start + std::chrono::microseconds(
+                             sent * 1000000ull / ((uint64_t)opt.kbps * 1024));
+      std::this_thread::sleep_until(due);
+    }
+  }
+  return true;
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// HTTP/1.1 with keep-alive, one thread per connection
+// ─────────────────────────────────────────────────────────────────────────────
+static std::mutex rngMtx;
+static std::mt19937 rng;
+
+static bool injectError() {
+  if (opt.errorRate <= 0.0)
+    return false;
+  std::lock_guard<std::mutex> lock(rngMtx);
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng) <
+         opt.errorRate;
+}
+
+static void serveConnection(int fd) {
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  std::string in;
+  char buf[4096];
+  for (;;) {
+    size_t end;
+    while ((end = in.find("\r\n\r\n")) == std::string::npos) {
+      ssize_t r = recv(fd, buf, sizeof(buf), 0);
+      if (r <= 0) {
+        close(fd);
+        return;
+      }
+      in.append(buf, r);
+    }
+    std::string request = in.substr(0, end);
+    in.erase(0, end + 4);
+
+    char method[16], target[2048];
+    if (sscanf(request.c_str(), "%15s %2047s", method, target) != 2)
+      break;
+    bool keepAlive = request.find("Connection: close") == std::string::npos;
+
+    std::string body, type = "text/plain";
+    int status = 200;
+    if (injectError()) {
+      status = opt.errorCode;
+      body = "injected error\n";
+    } else if (!lookup(target, body, type)) {
+      status = 404;
+      body = "not found\n";
+    }
+
+    char header[256];
+    snprintf(header, sizeof(header),
+             "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+             "Connection: %s\r\n\r\n",
+             status, status == 200 ? "OK" : "Error", type.c_str(), body.size(),
+             keepAlive ? "keep-alive" : "close");
+    printf("%s %s -> %d (%zu bytes)\n", method, target, status, body.size());
+
+    if (opt.latencyMs)
+      std::this_thread::sleep_for(std::chrono::milliseconds(opt.latencyMs));
+    if (!sendAll(fd, header, strlen(header)) ||
+        (strcmp(method, "HEAD") != 0 && !sendShaped(fd, body)) || !keepAlive)
+      break;
+  }
+  close(fd);
+}
+
+int main(int argc, char *argv[]) {
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(argv[i], "--port") && hasValue)
+      opt.port = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--pages") && hasValue)
+      opt.pages = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--pages-dir") && hasValue)
+      opt.pagesDir = argv[++i];
+    else if (!strcmp(argv[i], "--session") && hasValue)
+      opt.sessionDir = argv[++i];
+    else if (!strcmp(argv[i], "--latency") && hasValue)
+      opt.latencyMs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--kbps") && hasValue)
+      opt.kbps = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--stall-bytes") && hasValue)
+      opt.stallBytes = strtoull(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--stall-ms") && hasValue)
+      opt.stallMs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--error-rate") && hasValue)
+      opt.errorRate = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--error-code") && hasValue)
+      opt.errorCode = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && hasValue)
+      opt.seed = (unsigned)atoi(argv[++i]);
+    else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  rng.seed(opt.seed);
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  origin = "http://127.0.0.1:" + std::to_string(opt.port);
+
+  if (!opt.sessionDir.empty() && !loadSession(opt.sessionDir)) {
+    fprintf(stderr, "cannot read session %s\n", opt.sessionDir.c_str());
+    return 1;
+  }
+  if (!opt.pagesDir.empty())
+    loadPagesDir(opt.pagesDir);
+
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(opt.port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(listener, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+      listen(listener, 16) < 0) {
+    perror("bind");
+    return 1;
+  }
+  printf("serving %s%s\n", origin.c_str(),
+         opt.sessionDir.empty() ? CHAPTER_PATH : " (recorded session)");
+  fflush(stdout);
+
+  for (;;) {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd >= 0)
+      std::thread(serveConnection, fd).detach();
+  }
+}